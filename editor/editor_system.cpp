@@ -337,8 +337,7 @@ void EditorSystem::drawDefaultUI(float deltaMilliseconds)
 						if (ImGui::MenuItem(entityClassFile.string().c_str(), ""))
 						{
 							Variant callReturn = EventManager::GetSingleton()->returnCall("EditorFileCreateNewEntity", "EditorCreateNewEntity", entityClassFile.string());
-							Ref<Entity> newEntity = Extract(Ref<Entity>, callReturn);
-							EventManager::GetSingleton()->call("EditorFileOpenNewlyCreatedEntity", "EditorOpenEntity", newEntity);
+							EventManager::GetSingleton()->call("EditorFileOpenNewlyCreatedEntity", "EditorOpenEntity", Extract(EntityHandle, callReturn));
 						}
 					}
 					ImGui::EndMenu();
@@ -827,8 +826,8 @@ Variant EditorSystem::createNewEntity(const Event* event)
 
 	Ref<Entity> newEntity = EntityFactory::GetSingleton()->createEntity(entityClassFile);
 
-	HierarchySystem::GetSingleton()->addChild(newEntity);
-	return newEntity;
+	HierarchySystem::GetSingleton()->addChild(newEntity.get());
+	return newEntity->getHandle();
 }
 
 Variant EditorSystem::createNewMaterial(const Event* event)
@@ -13,7 +13,7 @@ void HierarchyDock::showHierarchySubTree(HierarchyComponent* hierarchy)
 {
 	if (hierarchy)
 	{
-		Ref<Entity> node = hierarchy->getOwner();
+		Entity* node = hierarchy->getOwner();
 
 		if (ImGui::TreeNodeEx(("##" + std::to_string(node->getID())).c_str(), ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_AllowItemOverlap | (hierarchy->getChildren().size() ? ImGuiTreeNodeFlags_None : ImGuiTreeNodeFlags_Leaf)))
 		{
@@ -43,7 +43,7 @@ void HierarchyDock::showHierarchySubTree(HierarchyComponent* hierarchy)
 
 				if (ImGui::BeginDragDropSource())
 				{
-					ImGui::SetDragDropPayload("RearrangeEntity", &node, sizeof(Ref<Entity>));
+					ImGui::SetDragDropPayload("RearrangeEntity", &node->getHandle(), sizeof(EntityHandle));
 					ImGui::Text(node->getFullName().c_str());
 					ImGui::EndDragDropSource();
 				}
@@ -55,19 +55,21 @@ void HierarchyDock::showHierarchySubTree(HierarchyComponent* hierarchy)
 						const char* newEntityFile = (const char*)payload->Data;
 						TextResourceFile* entityClassFile = ResourceLoader::CreateTextResourceFile(newEntityFile);
 						Ref<Entity> entity = EntityFactory::GetSingleton()->createEntityFromClass(entityClassFile);
-						node->getComponent<HierarchyComponent>()->snatchChild(entity);
-						openEntity(entity);
+						node->getComponentPtr<HierarchyComponent>()->snatchChild(entity.get());
+						openEntity(entity.get());
 					}
 
 					if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("RearrangeEntity"))
 					{
-						Ref<Entity> rearrangeEntity = *(Ref<Entity>*)(payload->Data);
-						node->getComponent<HierarchyComponent>()->snatchChild(rearrangeEntity);
-						rearrangeEntity->getComponent<TransformComponent>()->setTransform(
-						    rearrangeEntity->getComponent<TransformComponent>()->getAbsoluteTransform()
-						    * node->getComponent<TransformComponent>()->getAbsoluteTransform().Invert()
-						);
-						openEntity(rearrangeEntity);
+						if (Entity* rearrangeEntity = EntityFactory::GetSingleton()->resolveEntity(*(const EntityHandle*)(payload->Data)))
+						{
+							node->getComponentPtr<HierarchyComponent>()->snatchChild(rearrangeEntity);
+							rearrangeEntity->getComponentPtr<TransformComponent>()->setTransform(
+							    rearrangeEntity->getComponentPtr<TransformComponent>()->getAbsoluteTransform()
+							    * node->getComponentPtr<TransformComponent>()->getAbsoluteTransform().Invert()
+							);
+							openEntity(rearrangeEntity);
+						}
 					}
 					ImGui::EndDragDropTarget();
 				}
@@ -75,7 +77,7 @@ void HierarchyDock::showHierarchySubTree(HierarchyComponent* hierarchy)
 
 			ImGui::PopStyleColor(1);
 
-			for (auto& child : node->getComponent<HierarchyComponent>()->getChildren())
+			for (auto& child : node->getComponentPtr<HierarchyComponent>()->getChildren())
 			{
 				showHierarchySubTree(child);
 			}
@@ -85,16 +87,17 @@ void HierarchyDock::showHierarchySubTree(HierarchyComponent* hierarchy)
 	}
 }
 
-void HierarchyDock::openEntity(Ref<Entity> entity)
+void HierarchyDock::openEntity(Entity* entity)
 {
 	m_OpenedEntityID = entity->getID();
 	PRINT("Viewed " + entity->getFullName() + " through Hierarchy Dock");
-	EventManager::GetSingleton()->call("OpenEntity", "EditorOpenEntity", entity);
+	EventManager::GetSingleton()->call("OpenEntity", "EditorOpenEntity", entity->getHandle());
 }
 
 Variant HierarchyDock::selectOpenEntity(const Event* event)
 {
-	m_OpenedEntityID = Extract(Ref<Entity>, event->getData())->getID();
+	Entity* entity = EntityFactory::GetSingleton()->resolveEntity(Extract(EntityHandle, event->getData()));
+	m_OpenedEntityID = entity ? entity->getID() : INVALID_ID;
 	return true;
 }
 
@@ -145,11 +148,11 @@ void HierarchyDock::showEntities(const HashMap<EntityID, Ref<Entity>>& entities)
 			ImGui::Separator();
 			if (ImGui::Selectable(entity->getFullName().c_str(), m_OpenedEntityID == entity->getID()))
 			{
-				openEntity(entity);
+				openEntity(entity.get());
 			}
 			if (ImGui::BeginPopupContextItem())
 			{
-				InspectorDock::GetSingleton()->drawEntityActions(entity);
+				InspectorDock::GetSingleton()->drawEntityActions(entity.get());
 				ImGui::EndPopup();
 			}
 			ImGui::NextColumn();
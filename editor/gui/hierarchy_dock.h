@@ -17,7 +17,7 @@ private:
 	bool m_IsShowEditorEntities = false;
 
 	void showHierarchySubTree(HierarchyComponent* hierarchy);
-	void openEntity(Ref<Entity> entity);
+	void openEntity(Entity* entity);
 
 	Variant selectOpenEntity(const Event* event);
 
@@ -14,8 +14,15 @@ InspectorDock* InspectorDock::s_Singleton = nullptr;
 
 Variant InspectorDock::openEntity(const Event* event)
 {
-	m_OpenedEntity = Extract(Ref<Entity>, event->getData());
-	m_OpenedEntityName = m_OpenedEntity->getName();
+	m_OpenedEntity = Extract(EntityHandle, event->getData());
+	Entity* openedEntity = getOpenedEntity();
+	if (!openedEntity)
+	{
+		WARN("Tried to open an entity that has been destroyed");
+		m_OpenedEntity = {};
+		return false;
+	}
+	m_OpenedEntityName = openedEntity->getName();
 	m_IsNameBeingEdited = false;
 	refreshAddNewComponentSelectionCache();
 	return true;
@@ -23,7 +30,7 @@ Variant InspectorDock::openEntity(const Event* event)
 
 Variant InspectorDock::closeEntity(const Event* event)
 {
-	m_OpenedEntity = nullptr;
+	m_OpenedEntity = {};
 	m_OpenedEntityName = "";
 	m_IsNameBeingEdited = false;
 	return true;
@@ -39,7 +46,7 @@ void InspectorDock::refreshAddNewComponentSelectionCache()
 }
 
 InspectorDock::InspectorDock()
-    : m_OpenedEntity(nullptr)
+    : m_OpenedEntity()
 {
 	BIND_EVENT_MEMBER_FUNCTION("EditorOpenEntity", openEntity);
 	BIND_EVENT_MEMBER_FUNCTION("EditorCloseEntity", closeEntity);
@@ -54,10 +61,15 @@ InspectorDock::InspectorDock()
 	}
 }
 
-void InspectorDock::drawEntityActions(Ref<Entity> actionEntity)
+Entity* InspectorDock::getOpenedEntity() const
+{
+	return EntityFactory::GetSingleton()->resolveEntity(m_OpenedEntity);
+}
+
+void InspectorDock::drawEntityActions(Entity* actionEntity)
 {
-	m_ActionEntity = actionEntity;
-	if (!m_OpenedEntity)
+	m_ActionEntity = actionEntity->getHandle();
+	if (!getOpenedEntity())
 	{
 		EventManager::GetSingleton()->call("OpenEntity", "EditorOpenEntity", m_ActionEntity);
 	}
@@ -71,18 +83,18 @@ void InspectorDock::drawEntityActions(Ref<Entity> actionEntity)
 	}
 	if (ImGui::Selectable("Reset"))
 	{
-		PANIC(m_ActionEntity->setupComponents() == false, "Could not setup entity: " + m_ActionEntity->getFullName());
+		PANIC(actionEntity->setupComponents() == false, "Could not setup entity: " + actionEntity->getFullName());
 	}
 	if (ImGui::Selectable("Save Entity as class"))
 	{
-		if (!EntityFactory::GetSingleton()->saveEntityAsClass(m_ActionEntity))
+		if (!EntityFactory::GetSingleton()->saveEntityAsClass(actionEntity))
 		{
 			WARN("Could not create class from selected entity");
 		}
 	}
 	if (ImGui::Selectable("Copy Entity"))
 	{
-		if (!EntityFactory::GetSingleton()->copyEntity(m_ActionEntity))
+		if (!EntityFactory::GetSingleton()->copyEntity(actionEntity))
 		{
 			WARN("Could not copy from selected entity");
 		}
@@ -90,7 +102,7 @@ void InspectorDock::drawEntityActions(Ref<Entity> actionEntity)
 	ImGui::Separator();
 	if (ImGui::Selectable("Delete Entity"))
 	{
-		if (m_ActionEntity->getID() != ROOT_ENTITY_ID)
+		if (actionEntity->getID() != ROOT_ENTITY_ID)
 		{
 			EventManager::GetSingleton()->deferredCall("EditorDeleteEntity", "DeleteEntity", m_ActionEntity);
 		}
@@ -107,13 +119,14 @@ void InspectorDock::draw(float deltaMilliseconds)
 	{
 		if (ImGui::Begin("Inspector"))
 		{
-			if (m_OpenedEntity)
+			Entity* openedEntity = getOpenedEntity();
+			if (openedEntity)
 			{
 				if (m_IsNameBeingEdited)
 				{
 					if (ImGui::InputText("Entity Name", &m_OpenedEntityName, ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_AutoSelectAll))
 					{
-						m_OpenedEntity->setName(m_OpenedEntityName);
+						openedEntity->setName(m_OpenedEntityName);
 						m_IsNameBeingEdited = false;
 					}
 					if (!ImGui::IsItemHovered() && ImGui::IsMouseClicked(ImGuiMouseButton_Left))
@@ -124,7 +137,7 @@ void InspectorDock::draw(float deltaMilliseconds)
 				else
 				{
 					EditorSystem::GetSingleton()->pushBoldFont();
-					ImGui::TreeNodeEx(m_OpenedEntity->getFullName().c_str(), ImGuiTreeNodeFlags_CollapsingHeader | ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_Selected);
+					ImGui::TreeNodeEx(openedEntity->getFullName().c_str(), ImGuiTreeNodeFlags_CollapsingHeader | ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_Selected);
 					if (ImGui::IsItemClicked(ImGuiMouseButton_Left))
 					{
 						m_IsNameBeingEdited = true;
@@ -135,13 +148,14 @@ void InspectorDock::draw(float deltaMilliseconds)
 				ImGui::SetNextItemWidth(ImGui::GetContentRegionAvailWidth());
 				if (ImGui::BeginCombo("##Entity Actions", "Select an action"))
 				{
-					drawEntityActions(m_OpenedEntity);
+					drawEntityActions(openedEntity);
 					ImGui::EndCombo();
 				}
 
-				if (!m_MenuAction.empty())
+				Entity* actionEntity = EntityFactory::GetSingleton()->resolveEntity(m_ActionEntity);
+				if (!m_MenuAction.empty() && actionEntity)
 				{
-					ImGui::OpenPopup((m_MenuAction + ": " + m_ActionEntity->getName()).c_str());
+					ImGui::OpenPopup((m_MenuAction + ": " + actionEntity->getName()).c_str());
 					m_MenuAction.clear();
 				}
 
@@ -149,7 +163,7 @@ void InspectorDock::draw(float deltaMilliseconds)
 
 				EditorSystem::GetSingleton()->pushBoldFont();
 				ImGui::Text("Components");
-				for (auto& component : m_OpenedEntity->getAllComponents())
+				for (auto& component : openedEntity->getAllComponents())
 				{
 					if (ImGui::TreeNodeEx(component.second->getName().c_str(), ImGuiTreeNodeFlags_CollapsingHeader | ImGuiTreeNodeFlags_DefaultOpen))
 					{
@@ -160,10 +174,10 @@ void InspectorDock::draw(float deltaMilliseconds)
 				}
 				EditorSystem::GetSingleton()->popFont();
 
-				if (m_ActionEntity)
+				if (actionEntity)
 				{
-					drawAddComponentWindow();
-					drawRemoveComponentWindow();
+					drawAddComponentWindow(actionEntity);
+					drawRemoveComponentWindow(actionEntity);
 				}
 			}
 		}
@@ -171,10 +185,10 @@ void InspectorDock::draw(float deltaMilliseconds)
 	}
 }
 
-void InspectorDock::drawAddComponentWindow()
+void InspectorDock::drawAddComponentWindow(Entity* actionEntity)
 {
 	ImGui::SetNextWindowSize({ ImGui::GetWindowWidth(), ImGui::GetWindowHeight() });
-	if (ImGui::BeginPopupModal(("Add Components: " + m_ActionEntity->getName()).c_str(), 0, ImGuiWindowFlags_AlwaysAutoResize))
+	if (ImGui::BeginPopupModal(("Add Components: " + actionEntity->getName()).c_str(), 0, ImGuiWindowFlags_AlwaysAutoResize))
 	{
 		ImGui::Text("%s", "Choose Components");
 		ImGui::SetNextItemWidth(ImGui::GetContentRegionAvailWidth());
@@ -183,7 +197,7 @@ void InspectorDock::drawAddComponentWindow()
 			for (auto&& [componentID, componentName, isComponentSelected] : m_AddNewComponentSelectionCache)
 			{
 				ImGui::SetNextItemWidth(ImGui::GetContentRegionAvailWidth());
-				if (!m_ActionEntity->hasComponent(componentID))
+				if (!actionEntity->hasComponent(componentID))
 				{
 					ImGui::Checkbox(componentName.c_str(), &isComponentSelected);
 				}
@@ -214,8 +228,8 @@ void InspectorDock::drawAddComponentWindow()
 				if (isComponentSelected)
 				{
 					Ref<Component> component = EntityFactory::GetSingleton()->createDefaultComponent(componentName);
-					EntityFactory::GetSingleton()->addComponent(m_ActionEntity, component);
-					PRINT("Added " + componentName + " to " + m_ActionEntity->getName());
+					EntityFactory::GetSingleton()->addComponent(actionEntity, component);
+					PRINT("Added " + componentName + " to " + actionEntity->getName());
 				}
 			}
 			refreshAddNewComponentSelectionCache();
@@ -233,10 +247,10 @@ void InspectorDock::drawAddComponentWindow()
 	}
 }
 
-void InspectorDock::drawRemoveComponentWindow()
+void InspectorDock::drawRemoveComponentWindow(Entity* actionEntity)
 {
 	ImGui::SetNextWindowSize({ ImGui::GetWindowWidth(), ImGui::GetWindowHeight() });
-	if (ImGui::BeginPopupModal(("Remove Components: " + m_ActionEntity->getName()).c_str(), 0, ImGuiWindowFlags_AlwaysAutoResize))
+	if (ImGui::BeginPopupModal(("Remove Components: " + actionEntity->getName()).c_str(), 0, ImGuiWindowFlags_AlwaysAutoResize))
 	{
 		ImGui::Text("%s", "Choose Components");
 		ImGui::SetNextItemWidth(ImGui::GetContentRegionAvailWidth());
@@ -245,7 +259,7 @@ void InspectorDock::drawRemoveComponentWindow()
 			for (auto&& [componentID, componentName, isComponentSelected] : m_AddNewComponentSelectionCache)
 			{
 				ImGui::SetNextItemWidth(ImGui::GetContentRegionAvailWidth());
-				if (m_ActionEntity->hasComponent(componentID))
+				if (actionEntity->hasComponent(componentID))
 				{
 					ImGui::Checkbox(componentName.c_str(), &isComponentSelected);
 				}
@@ -275,18 +289,18 @@ void InspectorDock::drawRemoveComponentWindow()
 			{
 				if (isComponentSelected)
 				{
-					Ref<Component> component = m_ActionEntity->getComponentFromID(componentID);
+					Ref<Component> component = actionEntity->getComponentFromID(componentID);
 					if (component)
 					{
-						m_ActionEntity->removeComponent(component);
-						PRINT("Deleted " + componentName + " from " + m_ActionEntity->getName());
+						actionEntity->removeComponent(component);
+						PRINT("Deleted " + componentName + " from " + actionEntity->getName());
 					}
 					else
 					{
 						ERR("Component not found: Possible level file corruption");
 					}
 				}
-				m_ActionEntity->setupComponents();
+				actionEntity->setupComponents();
 			}
 			refreshAddNewComponentSelectionCache();
 			ImGui::CloseCurrentPopup();
@@ -16,18 +16,18 @@ private:
 	constexpr static unsigned int s_InputTextBufferSize = 256;
 
 	InspectorSettings m_InspectorSettings;
-	Ref<Entity> m_OpenedEntity;
+	EntityHandle m_OpenedEntity;
 	String m_OpenedEntityName;
 	bool m_IsNameBeingEdited;
 	String m_MenuAction;
-	Ref<Entity> m_ActionEntity;
+	EntityHandle m_ActionEntity;
 	Vector<Tuple<ComponentID, String, bool>> m_AddNewComponentSelectionCache;
 	
 	Variant openEntity(const Event* event);
 	Variant closeEntity(const Event* event);
 
-	void drawAddComponentWindow();
-	void drawRemoveComponentWindow();
+	void drawAddComponentWindow(Entity* actionEntity);
+	void drawRemoveComponentWindow(Entity* actionEntity);
 	void refreshAddNewComponentSelectionCache();
 
 public:
@@ -39,8 +39,9 @@ public:
 
 	void draw(float deltaMilliseconds);
 
-	void drawEntityActions(Ref<Entity> actionEntity);
-	Ref<Entity> getOpenedEntity() { return m_OpenedEntity; }
+	void drawEntityActions(Entity* actionEntity);
+	/// Returns nullptr if nothing is open or the opened entity has been destroyed.
+	Entity* getOpenedEntity() const;
 	InspectorSettings& getSettings() { return m_InspectorSettings; }
 	void setActive(bool enabled) { m_InspectorSettings.m_IsActive = enabled; }
 };
@@ -2,6 +2,7 @@
 
 #include "renderer/rendering_device.h"
 #include "framework/systems/render_system.h"
+#include "framework/systems/spatial_system.h"
 #include "input/input_manager.h"
 #include "ui/input_interface.h"
 
@@ -19,7 +20,7 @@ ViewportDock::ViewportDock(const JSON::json& viewportJSON)
 	m_ViewportDockSettings.m_ImageBorderColor = EditorSystem::GetSingleton()->getColors().m_Accent;
 	TextResourceFile* cameraFile = ResourceLoader::CreateTextResourceFile("editor/assets/entities/camera.entity.json");
 	m_EditorCamera = EntityFactory::GetSingleton()->createEntity(cameraFile, true);
-	RenderSystem::GetSingleton()->setCamera(m_EditorCamera->getComponent<CameraComponent>().get());
+	RenderSystem::GetSingleton()->setCamera(m_EditorCamera->getComponentPtr<CameraComponent>());
 
 	TextResourceFile* gridFile = ResourceLoader::CreateTextResourceFile("editor/assets/entities/grid.entity.json");
 	m_EditorGrid = EntityFactory::GetSingleton()->createEntity(gridFile, true);
@@ -68,11 +69,11 @@ void ViewportDock::draw(float deltaMilliseconds)
 						Quaternion rotation;
 						Vector3 scale;
 						Vector3 position;
-						RenderSystem::GetSingleton()->getCamera()->getOwner()->getComponent<TransformComponent>()->getAbsoluteTransform().Decompose(scale, rotation, position);
+						RenderSystem::GetSingleton()->getCamera()->getOwner()->getComponentPtr<TransformComponent>()->getAbsoluteTransform().Decompose(scale, rotation, position);
 						transform->setPosition(position);
 						transform->setRotationQuaternion(rotation);
 					}
-					EventManager::GetSingleton()->call("OpenEntity", "EditorOpenEntity", entity);
+					EventManager::GetSingleton()->call("OpenEntity", "EditorOpenEntity", entity->getHandle());
 				}
 				ImGui::EndDragDropTarget();
 			}
@@ -151,12 +152,12 @@ void ViewportDock::draw(float deltaMilliseconds)
 			Matrix view = RenderSystem::GetSingleton()->getCamera()->getViewMatrix();
 			Matrix proj = RenderSystem::GetSingleton()->getCamera()->getProjectionMatrix();
 
-			Ref<Entity> openedEntity = InspectorDock::GetSingleton()->getOpenedEntity();
+			Entity* openedEntity = InspectorDock::GetSingleton()->getOpenedEntity();
 			if (openedEntity && openedEntity->getComponent<TransformComponent>())
 			{
 				ImGuizmo::SetRect(imagePos.x, imagePos.y, m_ViewportDockSettings.m_ImageSize.x, m_ViewportDockSettings.m_ImageSize.y);
 
-				Matrix matrix = openedEntity->getComponent<TransformComponent>()->getAbsoluteTransform();
+				Matrix matrix = openedEntity->getComponentPtr<TransformComponent>()->getAbsoluteTransform();
 				Matrix deltaMatrix = Matrix::CreateTranslation(0.0f, 0.0f, 0.0f);
 
 				Ref<TransformComponent> transform = openedEntity->getComponent<TransformComponent>();
@@ -225,44 +226,12 @@ void ViewportDock::draw(float deltaMilliseconds)
 
 				Ray ray(origin, direction);
 
-				float minimumDistance = D3D11_FLOAT32_MAX;
-				Ref<Entity> selectEntity;
-				for (auto& [entityID, entity] : EntityFactory::GetSingleton()->getEntities())
-				{
-					if (entity->isEditorOnly())
-					{
-						continue;
-					}
-
-					if (Ref<TransformComponent> transform = entity->getComponent<TransformComponent>())
-					{
-						static float distance = 0.0f;
-
-						BoundingBox boundingBox = transform->getBounds();
-						boundingBox.Center = boundingBox.Center + transform->getAbsoluteTransform().Translation();
-
-						boundingBox.Center.x *= transform->getScale().x;
-						boundingBox.Center.y *= transform->getScale().y;
-						boundingBox.Center.z *= transform->getScale().z;
-
-						boundingBox.Extents.x *= transform->getScale().x;
-						boundingBox.Extents.y *= transform->getScale().y;
-						boundingBox.Extents.z *= transform->getScale().z;
-
-						if (ray.Intersects(boundingBox, distance))
-						{
-							if (distance < minimumDistance && distance > 0.0f)
-							{
-								minimumDistance = distance;
-								selectEntity = entity;
-							}
-						}
-					}
-				}
+				float distance = 0.0f;
+				Entity* selectEntity = SpatialSystem::GetSingleton()->raycast(ray, D3D11_FLOAT32_MAX, [](Entity* entity) { return !entity->isEditorOnly(); }, distance);
 
 				if (selectEntity && selectEntity != openedEntity)
 				{
-					EventManager::GetSingleton()->call("MouseSelectEntity", "EditorOpenEntity", selectEntity);
+					EventManager::GetSingleton()->call("MouseSelectEntity", "EditorOpenEntity", selectEntity->getHandle());
 					PRINT("Picked entity through selection: " + selectEntity->getFullName());
 				}
 			}
@@ -297,12 +266,12 @@ void ViewportDock::draw(float deltaMilliseconds)
 
 				SetCursorPos(cursorWhenActivated.x, cursorWhenActivated.y);
 
-				m_EditorCamera->getComponent<TransformComponent>()->setRotation(
+				m_EditorCamera->getComponentPtr<TransformComponent>()->setRotation(
 				    m_EditorCameraYaw * m_EditorCameraSensitivity / m_EditorCameraRotationNormalizer,
 				    m_EditorCameraPitch * m_EditorCameraSensitivity / m_EditorCameraRotationNormalizer,
 				    0.0f);
 
-				m_ApplyCameraMatrix = m_EditorCamera->getComponent<TransformComponent>()->getLocalTransform();
+				m_ApplyCameraMatrix = m_EditorCamera->getComponentPtr<TransformComponent>()->getLocalTransform();
 
 				static const Vector3& forward = { 0.0f, 0.0f, -1.0f };
 				static const Vector3& right = { 1.0f, 0.0f, 0.0f };
@@ -341,7 +310,7 @@ void ViewportDock::draw(float deltaMilliseconds)
 					m_IsCameraMoving = false;
 				}
 			}
-			m_EditorCamera->getComponent<TransformComponent>()->setPosition(m_ApplyCameraMatrix.Translation());
+			m_EditorCamera->getComponentPtr<TransformComponent>()->setPosition(m_ApplyCameraMatrix.Translation());
 		}
 		ImGui::End();
 	}
@@ -1,6 +1,7 @@
 #include "application.h"
 
 #include "level_manager.h"
+#include "framework/entity_command_buffer.h"
 #include "framework/systems/audio_system.h"
 #include "core/resource_loader.h"
 #include "core/input/input_manager.h"
@@ -14,6 +15,8 @@
 #include "systems/render_system.h"
 #include "systems/script_system.h"
 #include "systems/hierarchy_system.h"
+#include "systems/light_system.h"
+#include "systems/transform_animation_system.h"
 
 Application* Application::s_Singleton = nullptr;
 
@@ -23,6 +26,7 @@ Application* Application::GetSingleton()
 }
 
 Application::Application(const String& settingsFile)
+    : m_SystemScheduler(m_ThreadPool)
 {
 	if (!s_Singleton)
 	{
@@ -38,6 +42,13 @@ Application::Application(const String& settingsFile)
 		ERR("Application OS was not initialized");
 	}
 
+	// Systems sharing an UpdateOrder are updated in the order they are created
+	PhysicsSystem::GetSingleton();
+	ScriptSystem::GetSingleton();
+	AudioSystem::GetSingleton();
+	LightSystem::GetSingleton();
+	TransformAnimationSystem::GetSingleton();
+
 	m_ApplicationSettings.reset(new ApplicationSettings(ResourceLoader::CreateTextResourceFile(settingsFile)));
 
 	JSON::json& systemsSettings = m_ApplicationSettings->getJSON()["systems"];
@@ -99,20 +110,12 @@ void Application::run()
 	{
 		m_FrameTimer.reset();
 
-		for (auto& [order, systems] : System::GetSystems())
-		{
-			for (auto& system : systems)
-			{
-				if (system->isActive())
-				{
-					system->update(m_FrameTimer.getLastFrameTime());
-				}
-			}
-		}
+		m_SystemScheduler.update(m_FrameTimer.getLastFrameTime());
 		
 		process(m_FrameTimer.getLastFrameTime());
 
 		EventManager::GetSingleton()->dispatchDeferred();
+		EntityCommandBuffer::GetSingleton()->apply();
 		m_Window->swapBuffers();
 	}
 
@@ -5,6 +5,7 @@
 #include "os/timer.h"
 #include "os/thread.h"
 #include "entity_factory.h"
+#include "system_scheduler.h"
 #include "application_settings.h"
 
 /// Interface for a Rootex application. 
@@ -17,6 +18,7 @@ protected:
 	Timer m_ApplicationTimer;
 	FrameTimer m_FrameTimer;
 	ThreadPool m_ThreadPool;
+	SystemScheduler m_SystemScheduler;
 
 	Ptr<Window> m_Window;
 	Ptr<ApplicationSettings> m_ApplicationSettings;
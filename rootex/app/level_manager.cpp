@@ -1,6 +1,7 @@
 #include "level_manager.h"
 
 #include "core/input/input_manager.h"
+#include "framework/entity_command_buffer.h"
 #include "framework/entity_factory.h"
 #include "framework/systems/hierarchy_system.h"
 #include "framework/systems/render_system.h"
@@ -176,6 +177,7 @@ void LevelManager::endLevel()
 			}
 		}
 
+		EntityCommandBuffer::GetSingleton()->clear();
 		EntityFactory::GetSingleton()->destroyEntities();
 		HierarchySystem::GetSingleton()->getRootHierarchyComponent()->clear();
 
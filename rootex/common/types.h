@@ -30,6 +30,12 @@ using Promise = std::promise<T>;
 template <class T>
 using Atomic = std::atomic<T>;
 
+#include <mutex>
+/// std::mutex
+typedef std::mutex Mutex;
+/// std::lock_guard over a Mutex
+typedef std::lock_guard<std::mutex> Lock;
+
 // Smart pointers
 #include <memory>
 /// std::unique_ptr
@@ -115,8 +121,21 @@ namespace ColorPresets = DirectX::Colors;
 /// Vector of std::variant of bool, int, char, float, String, Vector2, Vector3, Vector4, Matrix
 typedef Vector<std::variant<bool, int, char, float, String, Vector2, Vector3, Vector4, Matrix>> VariantVector;
 class Entity;
+/// Generational reference to an Entity, resolved through EntityFactory::resolveEntity().
+/// A handle outliving its entity resolves to nullptr instead of keeping the entity alive.
+struct EntityHandle
+{
+	/// Slot inside the EntityFactory handle table.
+	unsigned int m_Index = 0;
+	/// Incremented each time the slot is reused. 0 is never handed out, so default constructed handles are invalid.
+	unsigned int m_Generation = 0;
+
+	bool isValid() const { return m_Generation != 0; }
+	bool operator==(const EntityHandle& other) const { return m_Index == other.m_Index && m_Generation == other.m_Generation; }
+	bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+};
 /// A variant able to hold multiple kinds of data, one at a time.
-using Variant = std::variant<bool, int, char, float, String, Vector2, Vector3, Vector4, Matrix, VariantVector, Ref<Entity>, Vector<String>>;
+using Variant = std::variant<bool, int, char, float, String, Vector2, Vector3, Vector4, Matrix, VariantVector, EntityHandle, Vector<String>>;
 /// Extract the value of type TypeName from a Variant
 #define Extract(TypeName, variant) std::get<TypeName>((variant))
 
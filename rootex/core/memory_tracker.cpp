@@ -0,0 +1,156 @@
+#include "memory_tracker.h"
+
+MemoryCounter::MemoryCounter()
+    : m_Count(0)
+    , m_Bytes(0)
+    , m_PeakCount(0)
+    , m_PeakBytes(0)
+{
+}
+
+void MemoryCounter::RaisePeak(Atomic<size_t>& peak, size_t value)
+{
+	size_t current = peak.load(std::memory_order_relaxed);
+	while (current < value && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed))
+	{
+	}
+}
+
+void MemoryCounter::add(size_t bytes)
+{
+	RaisePeak(m_PeakCount, m_Count.fetch_add(1, std::memory_order_relaxed) + 1);
+	RaisePeak(m_PeakBytes, m_Bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+}
+
+void MemoryCounter::remove(size_t bytes)
+{
+	m_Count.fetch_sub(1, std::memory_order_relaxed);
+	m_Bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void MemoryCounter::resize(size_t oldBytes, size_t newBytes)
+{
+	if (newBytes > oldBytes)
+	{
+		RaisePeak(m_PeakBytes, m_Bytes.fetch_add(newBytes - oldBytes, std::memory_order_relaxed) + newBytes - oldBytes);
+	}
+	else
+	{
+		m_Bytes.fetch_sub(oldBytes - newBytes, std::memory_order_relaxed);
+	}
+}
+
+JSON::json MemoryCounter::getJSON() const
+{
+	JSON::json j;
+
+	j["count"] = getCount();
+	j["bytes"] = getBytes();
+	j["peakCount"] = getPeakCount();
+	j["peakBytes"] = getPeakBytes();
+
+	return j;
+}
+
+void MemoryTracker::RegisterAPI(sol::table& rootex)
+{
+	sol::usertype<MemoryTracker> memoryTracker = rootex.new_usertype<MemoryTracker>("MemoryTracker");
+	memoryTracker["GetCount"] = [](const String& category, const String& name) { return MemoryTracker::GetSingleton()->getCount(category, name); };
+	memoryTracker["GetBytes"] = [](const String& category, const String& name) { return MemoryTracker::GetSingleton()->getBytes(category, name); };
+	memoryTracker["GetPeakCount"] = [](const String& category, const String& name) { return MemoryTracker::GetSingleton()->getPeakCount(category, name); };
+	memoryTracker["GetPeakBytes"] = [](const String& category, const String& name) { return MemoryTracker::GetSingleton()->getPeakBytes(category, name); };
+	memoryTracker["GetReport"] = []() { return MemoryTracker::GetSingleton()->getJSON().dump(4); };
+	memoryTracker["SaveReport"] = [](const String& path) { return MemoryTracker::GetSingleton()->saveReport(path); };
+}
+
+MemoryTracker* MemoryTracker::GetSingleton()
+{
+	static MemoryTracker* singleton = new MemoryTracker();
+	return singleton;
+}
+
+MemoryCounter* MemoryTracker::getCounter(const String& category, const String& name)
+{
+	Lock lock(m_Mutex);
+	MemoryCounter*& counter = m_Counters[category][name];
+	if (!counter)
+	{
+		m_OwnedCounters.emplace_back(new MemoryCounter());
+		counter = m_OwnedCounters.back().get();
+	}
+	return counter;
+}
+
+void MemoryTracker::registerCounter(const String& category, const String& name, MemoryCounter* counter)
+{
+	Lock lock(m_Mutex);
+	m_Counters[category][name] = counter;
+}
+
+const MemoryCounter* MemoryTracker::findCounter(const String& category, const String& name) const
+{
+	Lock lock(m_Mutex);
+	auto&& findCategory = m_Counters.find(category);
+	if (findCategory == m_Counters.end())
+	{
+		return nullptr;
+	}
+	auto&& findName = findCategory->second.find(name);
+	if (findName == findCategory->second.end())
+	{
+		return nullptr;
+	}
+	return findName->second;
+}
+
+size_t MemoryTracker::getCount(const String& category, const String& name) const
+{
+	const MemoryCounter* counter = findCounter(category, name);
+	return counter ? counter->getCount() : 0;
+}
+
+size_t MemoryTracker::getBytes(const String& category, const String& name) const
+{
+	const MemoryCounter* counter = findCounter(category, name);
+	return counter ? counter->getBytes() : 0;
+}
+
+size_t MemoryTracker::getPeakCount(const String& category, const String& name) const
+{
+	const MemoryCounter* counter = findCounter(category, name);
+	return counter ? counter->getPeakCount() : 0;
+}
+
+size_t MemoryTracker::getPeakBytes(const String& category, const String& name) const
+{
+	const MemoryCounter* counter = findCounter(category, name);
+	return counter ? counter->getPeakBytes() : 0;
+}
+
+JSON::json MemoryTracker::getJSON() const
+{
+	Lock lock(m_Mutex);
+	JSON::json j = JSON::json::object();
+	for (auto&& [category, counters] : m_Counters)
+	{
+		for (auto&& [name, counter] : counters)
+		{
+			j[category][name] = counter->getJSON();
+		}
+	}
+	return j;
+}
+
+bool MemoryTracker::saveReport(const String& path) const
+{
+	InputOutputFileStream file = OS::CreateFileName(path);
+	if (!file)
+	{
+		ERR("Could not save memory report: " + path);
+		return false;
+	}
+	file << getJSON().dump(4) << std::endl;
+	file.close();
+	PRINT("Saved memory report: " + path);
+	return true;
+}
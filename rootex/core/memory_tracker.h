@@ -0,0 +1,69 @@
+#pragma once
+
+#include "common/common.h"
+
+/// Live count and byte size of one kind of allocation, along with their high-water marks.
+/// Updating costs a few relaxed atomic operations, so counters stay enabled in every build and may be touched from any thread.
+class MemoryCounter
+{
+	Atomic<size_t> m_Count;
+	Atomic<size_t> m_Bytes;
+	Atomic<size_t> m_PeakCount;
+	Atomic<size_t> m_PeakBytes;
+
+	static void RaisePeak(Atomic<size_t>& peak, size_t value);
+
+public:
+	MemoryCounter();
+	MemoryCounter(MemoryCounter&) = delete;
+	~MemoryCounter() = default;
+
+	/// Record a new live object taking up bytes.
+	void add(size_t bytes);
+	/// Record the release of a live object that took up bytes.
+	void remove(size_t bytes);
+	/// Record a live object changing its size from oldBytes to newBytes.
+	void resize(size_t oldBytes, size_t newBytes);
+
+	size_t getCount() const { return m_Count.load(std::memory_order_relaxed); }
+	size_t getBytes() const { return m_Bytes.load(std::memory_order_relaxed); }
+	size_t getPeakCount() const { return m_PeakCount.load(std::memory_order_relaxed); }
+	size_t getPeakBytes() const { return m_PeakBytes.load(std::memory_order_relaxed); }
+
+	JSON::json getJSON() const;
+};
+
+/// Registry of named MemoryCounters, grouped in categories like "Components", "Resources" and "Materials".
+class MemoryTracker
+{
+	mutable Mutex m_Mutex;
+	Map<String, Map<String, MemoryCounter*>> m_Counters;
+	Vector<Ptr<MemoryCounter>> m_OwnedCounters;
+
+	MemoryTracker() = default;
+	MemoryTracker(MemoryTracker&) = delete;
+	~MemoryTracker() = default;
+
+	const MemoryCounter* findCounter(const String& category, const String& name) const;
+
+public:
+	static void RegisterAPI(sol::table& rootex);
+	/// The tracker is never destroyed so that objects released during static destruction still find their counters.
+	static MemoryTracker* GetSingleton();
+
+	/// Get the counter registered under category and name, creating it if needed. Cache the returned pointer, it stays valid forever.
+	MemoryCounter* getCounter(const String& category, const String& name);
+	/// Report a counter owned elsewhere under category and name. The counter must never be destroyed.
+	void registerCounter(const String& category, const String& name, MemoryCounter* counter);
+
+	/// Returns 0 for counters that are not registered.
+	size_t getCount(const String& category, const String& name) const;
+	size_t getBytes(const String& category, const String& name) const;
+	size_t getPeakCount(const String& category, const String& name) const;
+	size_t getPeakBytes(const String& category, const String& name) const;
+
+	/// Snapshot of all counters, keyed by category and then by name.
+	JSON::json getJSON() const;
+	/// Write getJSON() to a file.
+	bool saveReport(const String& path) const;
+};
@@ -10,6 +10,7 @@ struct VertexBufferElement
 	/// Abstracts the DXGI input format types
 	enum Type
 	{
+		FloatFloatFloatFloat = DXGI_FORMAT_R32G32B32A32_FLOAT,
 		FloatFloatFloat = DXGI_FORMAT_R32G32B32_FLOAT,
 		FloatFloat = DXGI_FORMAT_R32G32_FLOAT,
 		ByteByteByteByte = DXGI_FORMAT_R8G8B8A8_UNORM
@@ -19,12 +20,18 @@ struct VertexBufferElement
 	Type m_Type; 
 	/// Used as the semantic of the Vertex Buffer element in shaders
 	LPCSTR m_Name;
+	/// Distinguishes elements sharing a semantic, like the rows of a matrix
+	unsigned int m_SemanticIndex;
+	/// Read once per instance from the instance buffer instead of once per vertex
+	bool m_IsPerInstance;
 
 	/// Total size of the Vertex Buffer
 	static unsigned int GetSize(Type type)
 	{
 		switch (type)
 		{
+		case FloatFloatFloatFloat:
+			return sizeof(float) * 4;
 		case FloatFloatFloat:
 			return sizeof(float) * 3;
 		case FloatFloat:
@@ -46,7 +53,8 @@ class BufferFormat
 public:
 	BufferFormat() = default;
 
-	void push(VertexBufferElement::Type type, LPCSTR name) { m_Elements.push_back({ type, name }); }
+	void push(VertexBufferElement::Type type, LPCSTR name) { m_Elements.push_back({ type, name, 0, false }); }
+	void pushPerInstance(VertexBufferElement::Type type, LPCSTR name, unsigned int semanticIndex) { m_Elements.push_back({ type, name, semanticIndex, true }); }
 
 	const Vector<VertexBufferElement>& getElements() const { return m_Elements; }
 };
@@ -0,0 +1,58 @@
+#include "instance_buffer.h"
+
+#include "rendering_device.h"
+
+InstanceBuffer::InstanceBuffer()
+    : m_Stride(sizeof(InstanceData))
+    , m_Capacity(0)
+{
+}
+
+void InstanceBuffer::create(unsigned int capacity)
+{
+	D3D11_BUFFER_DESC ibd = { 0 };
+	ibd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	ibd.Usage = D3D11_USAGE_DYNAMIC;
+	ibd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	ibd.MiscFlags = 0u;
+	ibd.ByteWidth = sizeof(InstanceData) * capacity;
+	ibd.StructureByteStride = sizeof(InstanceData);
+
+	const UINT offset = 0u;
+	m_InstanceBuffer = RenderingDevice::GetSingleton()->createVertexBuffer(&ibd, nullptr, &m_Stride, &offset);
+	m_Capacity = capacity;
+}
+
+void InstanceBuffer::setData(const Vector<InstanceData>& instances)
+{
+	setData(instances.data(), (unsigned int)instances.size());
+}
+
+void InstanceBuffer::setData(const InstanceData* instances, unsigned int count)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	if (count > m_Capacity)
+	{
+		unsigned int capacity = m_Capacity ? m_Capacity : INSTANCE_BUFFER_INITIAL_CAPACITY;
+		while (capacity < count)
+		{
+			capacity *= 2;
+		}
+		create(capacity);
+	}
+
+	D3D11_MAPPED_SUBRESOURCE subresource;
+	RenderingDevice::GetSingleton()->mapBuffer(m_InstanceBuffer.Get(), subresource);
+	memcpy(subresource.pData, instances, sizeof(InstanceData) * count);
+	RenderingDevice::GetSingleton()->unmapBuffer(m_InstanceBuffer.Get());
+}
+
+void InstanceBuffer::bind() const
+{
+	const UINT offset = 0u;
+	RenderingDevice::GetSingleton()->bindPerInstance(m_InstanceBuffer.Get(), INSTANCE_BUFFER_SLOT, &m_Stride, &offset);
+}
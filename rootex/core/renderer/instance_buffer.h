@@ -0,0 +1,33 @@
+#pragma once
+
+#include <d3d11.h>
+
+#include "common/common.h"
+#include "renderer/vertex_data.h"
+
+/// Input Assembler slot instance buffers are bound to, after the vertex buffer at slot 0
+#define INSTANCE_BUFFER_SLOT 1
+/// Instances the buffer holds before it first grows
+#define INSTANCE_BUFFER_INITIAL_CAPACITY 256
+
+/// Encapsulates a dynamic vertex buffer of per instance data, rewritten every time it is used and grown as needed
+class InstanceBuffer
+{
+	Microsoft::WRL::ComPtr<ID3D11Buffer> m_InstanceBuffer;
+	unsigned int m_Stride;
+	unsigned int m_Capacity;
+
+	void create(unsigned int capacity);
+
+public:
+	InstanceBuffer();
+	InstanceBuffer(InstanceBuffer&) = delete;
+	~InstanceBuffer() = default;
+
+	/// Replaces the contents of the buffer with instances.
+	void setData(const Vector<InstanceData>& instances);
+	/// Replaces the contents of the buffer with the first count instances.
+	void setData(const InstanceData* instances, unsigned int count);
+	void bind() const;
+	unsigned int getCapacity() const { return m_Capacity; }
+};
@@ -1,12 +1,20 @@
 #include "material.h"
 
 #include "shader_library.h"
+#include "framework/systems/render_system.h"
 
 void Material::bind()
 {
 	m_Shader->bind();
 }
 
+void Material::bindTransform(const Matrix& model)
+{
+	RenderSystem::GetSingleton()->pushMatrixOverride(model);
+	bind();
+	RenderSystem::GetSingleton()->popMatrix();
+}
+
 JSON::json Material::getJSON() const
 {
 	JSON::json j;
@@ -15,11 +23,52 @@ JSON::json Material::getJSON() const
 	return j;
 }
 
-Material::Material(Shader* shader, const String& typeName, bool isAlpha)
+void Material::updateTrackedBytes()
+{
+	size_t bytes = m_ClassBytes;
+	for (const Vector<Microsoft::WRL::ComPtr<ID3D11Buffer>>* constantBuffers : { &m_PSConstantBuffer, &m_VSConstantBuffer })
+	{
+		for (const Microsoft::WRL::ComPtr<ID3D11Buffer>& constantBuffer : *constantBuffers)
+		{
+			if (constantBuffer)
+			{
+				D3D11_BUFFER_DESC desc;
+				constantBuffer->GetDesc(&desc);
+				bytes += desc.ByteWidth;
+			}
+		}
+	}
+	m_MemoryCounter->resize(m_TrackedBytes, bytes);
+	m_TrackedBytes = bytes;
+}
+
+void Material::setFileName(const String& fileName)
+{
+	m_FileName = fileName;
+
+	MemoryCounter* counter = MemoryTracker::GetSingleton()->getCounter("Materials", fileName);
+	if (counter != m_MemoryCounter)
+	{
+		m_MemoryCounter->remove(m_TrackedBytes);
+		counter->add(m_TrackedBytes);
+		m_MemoryCounter = counter;
+	}
+}
+
+Material::Material(Shader* shader, const String& typeName, bool isAlpha, size_t classBytes)
     : m_Shader(shader)
     , m_TypeName(typeName)
     , m_IsAlpha(isAlpha)
+    , m_MemoryCounter(MemoryTracker::GetSingleton()->getCounter("Materials", typeName))
+    , m_ClassBytes(classBytes)
+    , m_TrackedBytes(classBytes)
+{
+	m_MemoryCounter->add(m_TrackedBytes);
+}
+
+Material::~Material()
 {
+	m_MemoryCounter->remove(m_TrackedBytes);
 }
 
 #ifdef ROOTEX_EDITOR
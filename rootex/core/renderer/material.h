@@ -2,6 +2,7 @@
 
 #include "constant_buffer.h"
 #include "shader.h"
+#include "core/memory_tracker.h"
 
 class Material
 {
@@ -13,7 +14,18 @@ protected:
 	String m_TypeName;
 	bool m_IsAlpha;
 
-	Material(Shader* shader, const String& typeName, bool isAlpha);
+	/// Counter of the MemoryTracker "Materials" category named after m_FileName, or after m_TypeName until a file name is set.
+	MemoryCounter* m_MemoryCounter;
+	/// Size of the most derived material class.
+	size_t m_ClassBytes;
+	size_t m_TrackedBytes;
+
+	/// classBytes is the size of the most derived material class, reported to the MemoryTracker.
+	Material(Shader* shader, const String& typeName, bool isAlpha, size_t classBytes);
+
+	/// Reports the class size and the created constant buffers to the MemoryTracker. Call after creating a constant buffer.
+	/// Textures are counted once each in the "Textures" category, since materials may share them.
+	void updateTrackedBytes();
 
 public:
 	template <typename T>
@@ -22,9 +34,18 @@ public:
 	static void SetVSConstantBuffer(const T& constantBuffer, Microsoft::WRL::ComPtr<ID3D11Buffer>& pointer, UINT slot);
 
 	Material() = delete;
-	virtual ~Material() = default;
+	virtual ~Material();
 
+	/// Binds everything needed to draw at the current RenderSystem matrix.
 	virtual void bind();
+	/// Binds the state shared by all objects drawn with this material. Followed by bindTransform() for each object.
+	virtual void bindMaterial() {}
+	/// Sets the per object state for drawing at model. Binds the whole material unless overridden.
+	virtual void bindTransform(const Matrix& model);
+	/// True if the material can be drawn with bindInstancedMaterial().
+	virtual bool isInstanceable() const { return false; }
+	/// Binds the state shared by all instances of an instanced draw, which read their per instance state from the instance buffer.
+	virtual void bindInstancedMaterial() {}
 	
 	bool isAlpha() { return m_IsAlpha; }
 	String getFileName() { return m_FileName; };
@@ -32,7 +53,8 @@ public:
 	String getFullName() { return m_FileName + " - " + m_TypeName; };
 	virtual JSON::json getJSON() const;
 	
-	void setFileName(const String& fileName) { m_FileName = fileName; };
+	/// Also moves the memory of the material to the MemoryTracker counter named after fileName.
+	void setFileName(const String& fileName);
 	
 #ifdef ROOTEX_EDITOR
 	virtual void draw(const String& id);
@@ -11,8 +11,9 @@
 #include "renderer/shaders/register_locations_vertex_shader.h"
 
 BasicMaterial::BasicMaterial(bool isAlpha, const String& imagePath, const String& normalImagePath, bool isNormal, Color color, bool isLit, float specularIntensity, float specularPower, float reflectivity, float refractionConstant, float refractivity, bool affectedBySky)
-    : Material(ShaderLibrary::GetBasicShader(), BasicMaterial::s_MaterialName, isAlpha)
+    : Material(ShaderLibrary::GetBasicShader(), BasicMaterial::s_MaterialName, isAlpha, sizeof(BasicMaterial))
     , m_BasicShader(ShaderLibrary::GetBasicShader())
+    , m_BasicInstancedShader(ShaderLibrary::GetBasicInstancedShader())
     , m_Color(color)
     , m_IsLit(isLit)
     , m_SpecularIntensity(specularIntensity)
@@ -45,12 +46,24 @@ BasicMaterial::BasicMaterial(bool isAlpha, const String& imagePath, const String
 
 void BasicMaterial::setPSConstantBuffer(const PSDiffuseConstantBufferMaterial& constantBuffer)
 {
-	Material::SetPSConstantBuffer<PSDiffuseConstantBufferMaterial>(constantBuffer, m_PSConstantBuffer[(int)PixelConstantBufferType::Material], PER_OBJECT_PS_CPP);
+	Microsoft::WRL::ComPtr<ID3D11Buffer>& buffer = m_PSConstantBuffer[(int)PixelConstantBufferType::Material];
+	const bool isCreated = buffer == nullptr;
+	Material::SetPSConstantBuffer<PSDiffuseConstantBufferMaterial>(constantBuffer, buffer, PER_OBJECT_PS_CPP);
+	if (isCreated)
+	{
+		updateTrackedBytes();
+	}
 }
 
 void BasicMaterial::setVSConstantBuffer(const VSDiffuseConstantBuffer& constantBuffer)
 {
-	Material::SetVSConstantBuffer<VSDiffuseConstantBuffer>(constantBuffer, m_VSConstantBuffer[(int)VertexConstantBufferType::Model], PER_OBJECT_VS_CPP);
+	Microsoft::WRL::ComPtr<ID3D11Buffer>& buffer = m_VSConstantBuffer[(int)VertexConstantBufferType::Model];
+	const bool isCreated = buffer == nullptr;
+	Material::SetVSConstantBuffer<VSDiffuseConstantBuffer>(constantBuffer, buffer, PER_OBJECT_VS_CPP);
+	if (isCreated)
+	{
+		updateTrackedBytes();
+	}
 }
 
 Material* BasicMaterial::CreateDefault()
@@ -114,17 +127,38 @@ Material* BasicMaterial::Create(const JSON::json& materialData)
 }
 
 void BasicMaterial::bind()
+{
+	bindMaterial();
+	bindTransform(RenderSystem::GetSingleton()->getCurrentMatrix());
+}
+
+void BasicMaterial::bindMaterial()
 {
 	Material::bind();
+	bindResources();
+}
+
+void BasicMaterial::bindInstancedMaterial()
+{
+	m_BasicInstancedShader->bind();
+	bindResources();
+}
+
+void BasicMaterial::bindResources()
+{
 	m_BasicShader->set(m_DiffuseTexture.get(), DIFFUSE_PS_CPP);
 	if (m_IsNormal)
 	{
 		m_BasicShader->set(m_NormalTexture.get(), NORMAL_PS_CPP);
 	}
-	setVSConstantBuffer(VSDiffuseConstantBuffer(RenderSystem::GetSingleton()->getCurrentMatrix()));
 	setPSConstantBuffer(PSDiffuseConstantBufferMaterial({ m_Color, m_IsLit, m_SpecularIntensity, m_SpecularPower, m_Reflectivity, m_RefractionConstant, m_Refractivity, m_IsAffectedBySky, m_IsNormal }));
 }
 
+void BasicMaterial::bindTransform(const Matrix& model)
+{
+	setVSConstantBuffer(VSDiffuseConstantBuffer(model));
+}
+
 JSON::json BasicMaterial::getJSON() const
 {
 	JSON::json& j = Material::getJSON();
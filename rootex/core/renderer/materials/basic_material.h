@@ -7,6 +7,7 @@ class Texture;
 class BasicMaterial : public Material
 {
 	BasicShader* m_BasicShader;
+	BasicShader* m_BasicInstancedShader;
 	Ref<Texture> m_DiffuseTexture;
 	Ref<Texture> m_NormalTexture;
 	Microsoft::WRL::ComPtr<ID3D11SamplerState> m_SamplerState;
@@ -26,6 +27,8 @@ class BasicMaterial : public Material
 
 	void setPSConstantBuffer(const PSDiffuseConstantBufferMaterial& constantBuffer);
 	void setVSConstantBuffer(const VSDiffuseConstantBuffer& constantBuffer);
+	/// Binds the textures and material constants, shared by the instanced and non instanced shaders.
+	void bindResources();
 
 #ifdef ROOTEX_EDITOR
 	String m_ImagePathUI;
@@ -60,6 +63,10 @@ public:
 	static Material* Create(const JSON::json& materialData);
 
 	void bind() override;
+	void bindMaterial() override;
+	void bindTransform(const Matrix& model) override;
+	bool isInstanceable() const override { return true; }
+	void bindInstancedMaterial() override;
 	JSON::json getJSON() const override;
 
 #ifdef ROOTEX_EDITOR
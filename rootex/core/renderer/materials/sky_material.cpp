@@ -11,7 +11,7 @@
 #include "renderer/shaders/register_locations_vertex_shader.h"
 
 SkyMaterial::SkyMaterial(const String& imagePath)
-    : Material(ShaderLibrary::GetSkyShader(), SkyMaterial::s_MaterialName, false)
+    : Material(ShaderLibrary::GetSkyShader(), SkyMaterial::s_MaterialName, false, sizeof(SkyMaterial))
     , m_SkyShader(ShaderLibrary::GetSkyShader())
 {
 	setTexture(ResourceLoader::CreateImageResourceFile(imagePath));
@@ -26,7 +26,13 @@ SkyMaterial::SkyMaterial(const String& imagePath)
 
 void SkyMaterial::setVSConstantBuffer(const VSDiffuseConstantBuffer& constantBuffer)
 {
-	Material::SetVSConstantBuffer<VSDiffuseConstantBuffer>(constantBuffer, m_VSConstantBuffer[(int)VertexConstantBufferType::Model], PER_OBJECT_VS_CPP);
+	Microsoft::WRL::ComPtr<ID3D11Buffer>& buffer = m_VSConstantBuffer[(int)VertexConstantBufferType::Model];
+	const bool isCreated = buffer == nullptr;
+	Material::SetVSConstantBuffer<VSDiffuseConstantBuffer>(constantBuffer, buffer, PER_OBJECT_VS_CPP);
+	if (isCreated)
+	{
+		updateTrackedBytes();
+	}
 }
 
 Material* SkyMaterial::CreateDefault()
@@ -43,7 +49,7 @@ void SkyMaterial::bind()
 {
 	Material::bind();
 	m_SkyShader->setSkyTexture(m_SkyTexture.get());
-	setVSConstantBuffer(VSDiffuseConstantBuffer(Matrix::CreateTranslation(RenderSystem::GetSingleton()->getCamera()->getOwner()->getComponent<TransformComponent>()->getAbsoluteTransform().Translation())));
+	setVSConstantBuffer(VSDiffuseConstantBuffer(Matrix::CreateTranslation(RenderSystem::GetSingleton()->getCamera()->getOwner()->getComponentPtr<TransformComponent>()->getAbsolutePosition())));
 }
 
 JSON::json SkyMaterial::getJSON() const
@@ -9,6 +9,8 @@ struct Mesh
 {
 	Ref<VertexBuffer> m_VertexBuffer;
 	Ref<IndexBuffer> m_IndexBuffer;
+	/// Box around all vertex positions, in model space.
+	BoundingBox m_BoundingBox;
 
 	Mesh() = default;
 	Mesh(const Mesh&) = default;
@@ -485,6 +485,11 @@ void RenderingDevice::bind(ID3D11Buffer* indexBuffer, DXGI_FORMAT format)
 	m_Context->IASetIndexBuffer(indexBuffer, format, 0u);
 }
 
+void RenderingDevice::bindPerInstance(ID3D11Buffer* instanceBuffer, unsigned int slot, const unsigned int* stride, const unsigned int* offset)
+{
+	m_Context->IASetVertexBuffers(slot, 1u, &instanceBuffer, stride, offset);
+}
+
 void RenderingDevice::bind(ID3D11VertexShader* vertexShader)
 {
 	m_Context->VSSetShader(vertexShader, nullptr, 0u);
@@ -684,6 +689,11 @@ void RenderingDevice::drawIndexed(UINT number)
 	m_Context->DrawIndexed(number, 0u, 0u);
 }
 
+void RenderingDevice::drawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT firstInstance)
+{
+	m_Context->DrawIndexedInstanced(indexCount, instanceCount, 0u, 0, firstInstance);
+}
+
 void RenderingDevice::beginDrawUI()
 {
 	m_FontBatch->Begin();
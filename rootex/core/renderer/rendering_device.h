@@ -109,6 +109,8 @@ public:
 
 	void bind(ID3D11Buffer* vertexBuffer, const unsigned int* stride, const unsigned int* offset);
 	void bind(ID3D11Buffer* indexBuffer, DXGI_FORMAT format);
+	/// Binds a vertex buffer read once per instance at slot
+	void bindPerInstance(ID3D11Buffer* instanceBuffer, unsigned int slot, const unsigned int* stride, const unsigned int* offset);
 	void bind(ID3D11VertexShader* vertexShader);
 	void bind(ID3D11PixelShader* pixelShader);
 	void bind(ID3D11InputLayout* inputLayout);
@@ -151,6 +153,7 @@ public:
 	
 	/// The last boss, draws Triangles
 	void drawIndexed(UINT number);
+	void drawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT firstInstance);
 	void beginDrawUI();
 	void endDrawUI();
 	void clearCurrentRenderTarget(const Color& color);
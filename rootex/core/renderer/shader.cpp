@@ -1,6 +1,7 @@
 #include "shader.h"
 
 #include "texture.h"
+#include "instance_buffer.h"
 
 #include "shaders/register_locations_pixel_shader.h"
 
@@ -26,11 +27,20 @@ Shader::Shader(const LPCWSTR& vertexPath, const LPCWSTR& pixelPath, const Buffer
 
 	Vector<D3D11_INPUT_ELEMENT_DESC> vertexDescArray;
 	unsigned int offset = 0;
+	unsigned int instanceOffset = 0;
 	for (auto& element : elements)
 	{
 		D3D11_INPUT_ELEMENT_DESC desc;
-		desc = { element.m_Name, 0, (DXGI_FORMAT)element.m_Type, 0, offset, D3D11_INPUT_PER_VERTEX_DATA, 0 };
-		offset += VertexBufferElement::GetSize(element.m_Type);
+		if (element.m_IsPerInstance)
+		{
+			desc = { element.m_Name, element.m_SemanticIndex, (DXGI_FORMAT)element.m_Type, INSTANCE_BUFFER_SLOT, instanceOffset, D3D11_INPUT_PER_INSTANCE_DATA, 1 };
+			instanceOffset += VertexBufferElement::GetSize(element.m_Type);
+		}
+		else
+		{
+			desc = { element.m_Name, element.m_SemanticIndex, (DXGI_FORMAT)element.m_Type, 0, offset, D3D11_INPUT_PER_VERTEX_DATA, 0 };
+			offset += VertexBufferElement::GetSize(element.m_Type);
+		}
 
 		vertexDescArray.push_back(desc);
 	}
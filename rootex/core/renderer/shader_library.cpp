@@ -15,6 +15,7 @@ Shader* ShaderLibrary::MakeShader(ShaderType shaderType, const LPCWSTR& vertexPa
 	switch (shaderType)
 	{
 	case ShaderLibrary::ShaderType::Basic:
+	case ShaderLibrary::ShaderType::BasicInstanced:
 		newShader = new BasicShader(vertexPath, pixelPath, vertexBufferFormat);
 		break;
 	case ShaderLibrary::ShaderType::Sky:
@@ -44,6 +45,18 @@ void ShaderLibrary::MakeShaders()
 		basicBufferFormat.push(VertexBufferElement::Type::FloatFloat, "TEXCOORD");
 		basicBufferFormat.push(VertexBufferElement::Type::FloatFloatFloat, "TANGENT");
 		MakeShader(ShaderType::Basic, L"rootex/assets/shaders/basic_vertex_shader.cso", L"rootex/assets/shaders/basic_pixel_shader.cso", basicBufferFormat);
+
+		BufferFormat basicInstancedBufferFormat = basicBufferFormat;
+		for (unsigned int row = 0; row < 4; row++)
+		{
+			basicInstancedBufferFormat.pushPerInstance(VertexBufferElement::Type::FloatFloatFloatFloat, "INSTANCE_TRANSFORM", row);
+		}
+		for (unsigned int row = 0; row < 4; row++)
+		{
+			basicInstancedBufferFormat.pushPerInstance(VertexBufferElement::Type::FloatFloatFloatFloat, "INSTANCE_INVERSE_TRANSPOSE", row);
+		}
+		basicInstancedBufferFormat.pushPerInstance(VertexBufferElement::Type::FloatFloatFloatFloat, "INSTANCE_COLOR", 0);
+		MakeShader(ShaderType::BasicInstanced, L"rootex/assets/shaders/basic_instanced_vertex_shader.cso", L"rootex/assets/shaders/basic_pixel_shader.cso", basicInstancedBufferFormat);
 	}
 	{
 		BufferFormat skyFormat;
@@ -62,6 +75,11 @@ BasicShader* ShaderLibrary::GetBasicShader()
 	return reinterpret_cast<BasicShader*>(s_Shaders[ShaderType::Basic].get());
 }
 
+BasicShader* ShaderLibrary::GetBasicInstancedShader()
+{
+	return reinterpret_cast<BasicShader*>(s_Shaders[ShaderType::BasicInstanced].get());
+}
+
 SkyShader* ShaderLibrary::GetSkyShader()
 {
 	return reinterpret_cast<SkyShader*>(s_Shaders[ShaderType::Sky].get());
@@ -9,6 +9,7 @@ class ShaderLibrary
 	enum class ShaderType
 	{
 		Basic,
+		BasicInstanced,
 		Sky
 	};
 
@@ -26,5 +27,7 @@ public:
 	static void DestroyShaders();
 
 	static BasicShader* GetBasicShader();
+	/// Basic shader reading the model matrix and color of each instance from the instance buffer.
+	static BasicShader* GetBasicInstancedShader();
 	static SkyShader* GetSkyShader();
 };
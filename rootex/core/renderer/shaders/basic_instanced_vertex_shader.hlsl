@@ -0,0 +1,54 @@
+#include "register_locations_vertex_shader.h"
+
+cbuffer CBuf : register(PER_FRAME_VS_HLSL)
+{
+    matrix V;
+	float fogStart;
+	float fogEnd;
+};
+
+cbuffer CBuf : register(PER_CAMERA_CHANGE_VS_HLSL)
+{
+    matrix P;
+};
+
+struct VertexInputType
+{
+    float4 position : POSITION;
+    float2 tex : TEXCOORD0;
+    float4 normal : NORMAL;
+	float3 tangent : TANGENT;
+    row_major matrix M : INSTANCE_TRANSFORM;
+    row_major matrix MInverseTranspose : INSTANCE_INVERSE_TRANSPOSE;
+    float4 color : INSTANCE_COLOR;
+};
+
+struct PixelInputType
+{
+    float4 screenPosition : SV_POSITION;
+    float3 normal : NORMAL;
+    float4 worldPosition : POSITION;
+    float2 tex : TEXCOORD0;
+	float fogFactor : FOG;
+	float3 tangent : TANGENT;
+    float4 color : COLOR;
+};
+
+PixelInputType main(VertexInputType input)
+{
+    PixelInputType output;
+    output.screenPosition = mul(input.position, mul(input.M, mul(V, P)));
+	output.normal = normalize(mul((float3)input.normal, (float3x3)input.MInverseTranspose));
+    output.worldPosition = mul(input.position, input.M);
+    output.tex.x = input.tex.x;
+    output.tex.y = 1 - input.tex.y;
+
+    output.tangent = mul(input.tangent, input.M);
+	
+    float4 cameraPosition = mul(input.position, mul(input.M, V));
+    output.fogFactor = saturate((fogEnd - cameraPosition.z) / (fogEnd - fogStart));
+
+    output.color = input.color;
+	
+	return output;
+}
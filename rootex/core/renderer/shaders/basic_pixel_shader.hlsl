@@ -13,6 +13,7 @@ struct PixelInputType
 	float2 tex : TEXCOORD0;
 	float fogFactor : FOG;
 	float3 tangent : TANGENT;
+    float4 color : COLOR;
 };
 struct PointLightInfo
 {
@@ -74,7 +75,7 @@ cbuffer Material : register(PER_OBJECT_PS_HLSL)
 
 float4 main(PixelInputType input) : SV_TARGET
 {
-    float4 materialColor = ShaderTexture.Sample(SampleType, input.tex) * color;
+    float4 materialColor = ShaderTexture.Sample(SampleType, input.tex) * color * input.color;
     float4 finalColor = materialColor;
     float3 toEye = normalize(cameraPos - (float3) input.worldPosition);
     
@@ -34,6 +34,7 @@ struct PixelInputType
     float2 tex : TEXCOORD0;
 	float fogFactor : FOG;
 	float3 tangent : TANGENT;
+    float4 color : COLOR;
 };
 
 PixelInputType main(VertexInputType input)
@@ -49,6 +50,8 @@ PixelInputType main(VertexInputType input)
 	
     float4 cameraPosition = mul(input.position, mul(M, V));
     output.fogFactor = saturate((fogEnd - cameraPosition.z) / (fogEnd - fogStart));
+
+    output.color = float4(1.0f, 1.0f, 1.0f, 1.0f);
 	
 	return output;
 }
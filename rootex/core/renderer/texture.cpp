@@ -2,15 +2,108 @@
 
 #include "rendering_device.h"
 #include "resource_loader.h"
+#include "core/memory_tracker.h"
+
+/// Bytes taken by a 2D texture resource, summed over array slices and mip levels. Unlisted formats are counted as 4 bytes per pixel.
+static size_t GetTextureBytes(ID3D11ShaderResourceView* textureView)
+{
+	if (!textureView)
+	{
+		return 0;
+	}
+
+	Microsoft::WRL::ComPtr<ID3D11Resource> resource;
+	textureView->GetResource(&resource);
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
+	if (FAILED(resource.As(&texture)))
+	{
+		return 0;
+	}
+	D3D11_TEXTURE2D_DESC desc;
+	texture->GetDesc(&desc);
+
+	bool isBlockCompressed = true;
+	size_t blockBytes = 16;
+	size_t pixelBytes = 4;
+	switch (desc.Format)
+	{
+	case DXGI_FORMAT_BC1_TYPELESS:
+	case DXGI_FORMAT_BC1_UNORM:
+	case DXGI_FORMAT_BC1_UNORM_SRGB:
+	case DXGI_FORMAT_BC4_TYPELESS:
+	case DXGI_FORMAT_BC4_UNORM:
+	case DXGI_FORMAT_BC4_SNORM:
+		blockBytes = 8;
+		break;
+	case DXGI_FORMAT_BC2_TYPELESS:
+	case DXGI_FORMAT_BC2_UNORM:
+	case DXGI_FORMAT_BC2_UNORM_SRGB:
+	case DXGI_FORMAT_BC3_TYPELESS:
+	case DXGI_FORMAT_BC3_UNORM:
+	case DXGI_FORMAT_BC3_UNORM_SRGB:
+	case DXGI_FORMAT_BC5_TYPELESS:
+	case DXGI_FORMAT_BC5_UNORM:
+	case DXGI_FORMAT_BC5_SNORM:
+	case DXGI_FORMAT_BC6H_TYPELESS:
+	case DXGI_FORMAT_BC6H_UF16:
+	case DXGI_FORMAT_BC6H_SF16:
+	case DXGI_FORMAT_BC7_TYPELESS:
+	case DXGI_FORMAT_BC7_UNORM:
+	case DXGI_FORMAT_BC7_UNORM_SRGB:
+		break;
+	case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		isBlockCompressed = false;
+		pixelBytes = 16;
+		break;
+	case DXGI_FORMAT_R16G16B16A16_FLOAT:
+	case DXGI_FORMAT_R16G16B16A16_UNORM:
+		isBlockCompressed = false;
+		pixelBytes = 8;
+		break;
+	case DXGI_FORMAT_R8_UNORM:
+	case DXGI_FORMAT_A8_UNORM:
+		isBlockCompressed = false;
+		pixelBytes = 1;
+		break;
+	default:
+		isBlockCompressed = false;
+		break;
+	}
+
+	size_t bytes = 0;
+	unsigned int width = desc.Width;
+	unsigned int height = desc.Height;
+	for (unsigned int mip = 0; mip < desc.MipLevels; mip++)
+	{
+		if (isBlockCompressed)
+		{
+			bytes += (size_t)((width + 3) / 4) * ((height + 3) / 4) * blockBytes;
+		}
+		else
+		{
+			bytes += (size_t)width * height * pixelBytes;
+		}
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+	return bytes * desc.ArraySize;
+}
 
 Texture::Texture(ImageResourceFile* imageFile)
     : m_ImageFile(imageFile)
+    , m_MemoryCounter(MemoryTracker::GetSingleton()->getCounter("Textures", imageFile->getPath().generic_string()))
+    , m_TrackedBytes(0)
 {
+	m_MemoryCounter->add(0);
 	loadTexture();
 }
 
 Texture::Texture(const char* imageData, int width, int height)
+    : m_ImageFile(nullptr)
+    , m_MemoryCounter(MemoryTracker::GetSingleton()->getCounter("Textures", "Generated"))
+    , m_TrackedBytes(0)
 {
+	m_MemoryCounter->add(0);
 	m_TextureView = RenderingDevice::GetSingleton()->createTextureFromPixels(imageData, width, height);
 
 	Microsoft::WRL::ComPtr<ID3D11Resource> res;
@@ -23,11 +116,15 @@ Texture::Texture(const char* imageData, int width, int height)
 	m_Width = textureDesc.Width;
 	m_Height = textureDesc.Height;
 	m_MipLevels = textureDesc.MipLevels;
+	trackBytes();
 }
 
 Texture::Texture(const char* imageFileData, size_t size)
     : m_ImageFile(nullptr)
+    , m_MemoryCounter(MemoryTracker::GetSingleton()->getCounter("Textures", "Embedded"))
+    , m_TrackedBytes(0)
 {
+	m_MemoryCounter->add(0);
 	m_TextureView = RenderingDevice::GetSingleton()->createTexture(imageFileData, size);
 
 	Microsoft::WRL::ComPtr<ID3D11Resource> res;
@@ -40,6 +137,7 @@ Texture::Texture(const char* imageFileData, size_t size)
 	m_Width = textureDesc.Width;
 	m_Height = textureDesc.Height;
 	m_MipLevels = textureDesc.MipLevels;
+	trackBytes();
 }
 
 void Texture::reload()
@@ -70,6 +168,24 @@ void Texture::loadTexture()
 	m_Width = textureDesc.Width;
 	m_Height = textureDesc.Height;
 	m_MipLevels = textureDesc.MipLevels;
+	trackBytes();
+}
+
+Texture::~Texture()
+{
+	m_MemoryCounter->remove(m_TrackedBytes);
+}
+
+void Texture::trackBytes()
+{
+	const size_t bytes = getByteSize();
+	m_MemoryCounter->resize(m_TrackedBytes, bytes);
+	m_TrackedBytes = bytes;
+}
+
+size_t Texture::getByteSize() const
+{
+	return GetTextureBytes(m_TextureView.Get());
 }
 
 Texture* Texture::GetCrossTexture()
@@ -81,14 +197,35 @@ Texture* Texture::GetCrossTexture()
 void Texture3D::loadTexture()
 {
 	m_TextureView = RenderingDevice::GetSingleton()->createDDSTexture(m_ImageFile);
+	trackBytes();
+}
+
+void Texture3D::trackBytes()
+{
+	const size_t bytes = getByteSize();
+	m_MemoryCounter->resize(m_TrackedBytes, bytes);
+	m_TrackedBytes = bytes;
 }
 
 Texture3D::Texture3D(ImageResourceFile* imageFile)
     : m_ImageFile(imageFile)
+    , m_MemoryCounter(MemoryTracker::GetSingleton()->getCounter("Textures", imageFile->getPath().generic_string()))
+    , m_TrackedBytes(0)
 {
+	m_MemoryCounter->add(0);
 	loadTexture();
 }
 
+Texture3D::~Texture3D()
+{
+	m_MemoryCounter->remove(m_TrackedBytes);
+}
+
+size_t Texture3D::getByteSize() const
+{
+	return GetTextureBytes(m_TextureView.Get());
+}
+
 void Texture3D::reload()
 {
 	m_TextureView.Reset();
@@ -3,6 +3,7 @@
 #include <d3d11.h>
 
 class ImageResourceFile;
+class MemoryCounter;
 
 /// Encapsulates all Texture related functionalities, uses DirectXTK behind the scenes
 class Texture
@@ -14,7 +15,13 @@ class Texture
 	unsigned int m_Height;
 	unsigned int m_MipLevels;
 
+	/// Counter of the MemoryTracker "Textures" category named after the image file. Each texture is counted once, however many materials use it.
+	MemoryCounter* m_MemoryCounter;
+	size_t m_TrackedBytes;
+
 	void loadTexture();
+	/// Reports getByteSize() to m_MemoryCounter. Call whenever the texture is created again.
+	void trackBytes();
 
 public:
 	Texture(ImageResourceFile* imageFile);
@@ -22,7 +29,7 @@ public:
 	Texture(const char* imageFileData, size_t size);
 	Texture(Texture&) = delete;
 	Texture& operator=(Texture&) = delete;
-	~Texture() = default;
+	~Texture();
 
 	void reload();
 
@@ -34,6 +41,8 @@ public:
 	unsigned int getHeight() const { return m_Height; }
 	unsigned int getMipLevels() const { return m_MipLevels; }
 	ImageResourceFile* getImage() const { return m_ImageFile; }
+	/// Video memory taken by every mip level.
+	size_t getByteSize() const;
 };
 
 /// Cube texture in 3D
@@ -41,17 +50,24 @@ class Texture3D
 {
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_TextureView;
 	ImageResourceFile* m_ImageFile;
+
+	/// Counter of the MemoryTracker "Textures" category named after the image file.
+	MemoryCounter* m_MemoryCounter;
+	size_t m_TrackedBytes;
 	
 	void loadTexture();
+	void trackBytes();
 
 public:
 	Texture3D(ImageResourceFile* imageFile);
 	Texture3D(Texture3D&) = delete;
 	Texture3D& operator=(Texture3D&) = delete;
-	~Texture3D() = default;
+	~Texture3D();
 
 	void reload();
 
 	ID3D11ShaderResourceView* getTextureResourceView() const { return m_TextureView.Get(); }
 	ImageResourceFile* getImage() const { return m_ImageFile; }
+	/// Video memory taken by every face and mip level.
+	size_t getByteSize() const;
 };
@@ -11,6 +11,16 @@ struct VertexData
 	Vector3 m_Tangent = { 0.0f, 0.0f, 0.0f };
 };
 
+/// Data sent once per instance of an instanced draw
+struct InstanceData
+{
+	/// Rows of the model matrix
+	Matrix m_Transform;
+	/// Rows of the inverse transpose of the model matrix, for transforming normals
+	Matrix m_InverseTransposeTransform;
+	Color m_Color;
+};
+
 struct UIVertexData
 {
 	Vector2 m_Position;
@@ -11,8 +11,11 @@
 ResourceFile::ResourceFile(const Type& type, ResourceData* resData)
     : m_Type(type)
     , m_ResourceData(resData)
+    , m_MemoryCounter(MemoryTracker::GetSingleton()->getCounter("Resources", GetTypeName(type)))
+    , m_TrackedBytes(resData ? resData->getRawDataByteSize() : 0)
 {
 	PANIC(resData == nullptr, "Null resource found. Resource of this type has not been loaded correctly: " + std::to_string((int)type));
+	m_MemoryCounter->add(m_TrackedBytes);
 	m_LastReadTime = OS::s_FileSystemClock.now();
 	m_LastChangedTime = OS::GetFileLastChangedTime(getPath().string());
 }
@@ -27,8 +30,37 @@ void ResourceFile::RegisterAPI(sol::table& rootex)
 	resourceFile["getType"] = &ResourceFile::getType;
 }
 
+String ResourceFile::GetTypeName(const Type& type)
+{
+	switch (type)
+	{
+	case Type::Lua:
+		return "Lua";
+	case Type::Audio:
+		return "Audio";
+	case Type::Text:
+		return "Text";
+	case Type::Model:
+		return "Model";
+	case Type::Image:
+		return "Image";
+	case Type::Font:
+		return "Font";
+	default:
+		return "None";
+	}
+}
+
 ResourceFile::~ResourceFile()
 {
+	m_MemoryCounter->remove(m_TrackedBytes);
+}
+
+void ResourceFile::updateTrackedBytes()
+{
+	size_t bytes = m_ResourceData ? m_ResourceData->getRawDataByteSize() : 0;
+	m_MemoryCounter->resize(m_TrackedBytes, bytes);
+	m_TrackedBytes = bytes;
 }
 
 bool ResourceFile::isValid()
@@ -115,16 +147,19 @@ void TextResourceFile::RegisterAPI(sol::table& rootex)
 void TextResourceFile::putString(const String& newData)
 {
 	*m_ResourceData->getRawData() = FileBuffer(newData.begin(), newData.end());
+	updateTrackedBytes();
 }
 
 void TextResourceFile::popBack()
 {
 	m_ResourceData->getRawData()->pop_back();
+	updateTrackedBytes();
 }
 
 void TextResourceFile::append(const String& add)
 {
 	m_ResourceData->getRawData()->insert(m_ResourceData->getRawData()->end(), add.begin(), add.end());
+	updateTrackedBytes();
 }
 
 String TextResourceFile::getString() const
@@ -152,6 +187,7 @@ void LuaTextResourceFile::RegisterAPI(sol::table& rootex)
 
 ModelResourceFile::ModelResourceFile(ResourceData* resData)
     : ResourceFile(Type::Model, resData)
+    , m_IsOccluderGeometryKept(false)
 {
 }
 
@@ -2,6 +2,7 @@
 
 #include "common/common.h"
 #include "core/resource_data.h"
+#include "core/memory_tracker.h"
 #include "core/renderer/mesh.h"
 #include "core/renderer/texture.h"
 #include "DirectXTK/Inc/SpriteFont.h"
@@ -29,12 +30,21 @@ protected:
 	FileTimePoint m_LastReadTime;
 	FileTimePoint m_LastChangedTime;
 
+	/// Counter of the MemoryTracker "Resources" category matching m_Type.
+	MemoryCounter* m_MemoryCounter;
+	/// Size of the resource data buffer last reported to m_MemoryCounter.
+	size_t m_TrackedBytes;
+
 	explicit ResourceFile(const Type& type, ResourceData* resData);
 
+	/// Report the current resource data buffer size to the MemoryTracker. Call after the buffer is replaced or resized.
+	void updateTrackedBytes();
+
 	friend class ResourceLoader;
 
 public:
 	static void RegisterAPI(sol::table& rootex);
+	static String GetTypeName(const Type& type);
 
 	virtual ~ResourceFile();
 	explicit ResourceFile(ResourceFile&) = delete;
@@ -136,6 +146,13 @@ class ModelResourceFile : public ResourceFile
 	~ModelResourceFile();
 
 	Vector<Pair<Ref<Material>, Vector<Mesh>>> m_Meshes;
+	/// Box around all meshes, in model space.
+	BoundingBox m_BoundingBox;
+	/// Vertex positions and triangle indices of all meshes kept on the CPU, for rasterizing the model as an occluder.
+	/// Only filled once ResourceLoader::LoadOccluderGeometry() has been called for this file.
+	Vector<Vector3> m_Positions;
+	Vector<unsigned int> m_Indices;
+	bool m_IsOccluderGeometryKept;
 
 	friend class ResourceLoader;
 
@@ -145,6 +162,9 @@ public:
 	explicit ModelResourceFile(ModelResourceFile&&) = delete;
 
 	Vector<Pair<Ref<Material>, Vector<Mesh>>>& getMeshes() { return m_Meshes; }
+	const BoundingBox& getBounds() const { return m_BoundingBox; }
+	const Vector<Vector3>& getPositions() const { return m_Positions; }
+	const Vector<unsigned int>& getIndices() const { return m_Indices; }
 };
 
 /// Representation of an image file. Supports BMP, JPEG, PNG, TIFF, GIF, HD Photo, or other WIC supported file containers
@@ -31,6 +31,47 @@ bool IsFileSupported(const String& extension, ResourceFile::Type supportedFileTy
 	return false;
 }
 
+void ResourceLoader::AppendOccluderGeometry(ModelResourceFile* file, const aiMesh* mesh)
+{
+	const unsigned int firstPosition = (unsigned int)file->m_Positions.size();
+	for (unsigned int v = 0; v < mesh->mNumVertices; v++)
+	{
+		file->m_Positions.push_back({ mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z });
+	}
+	for (unsigned int f = 0; f < mesh->mNumFaces; f++)
+	{
+		const aiFace& face = mesh->mFaces[f];
+		file->m_Indices.push_back(firstPosition + face.mIndices[0]);
+		file->m_Indices.push_back(firstPosition + face.mIndices[1]);
+		file->m_Indices.push_back(firstPosition + face.mIndices[2]);
+	}
+}
+
+void ResourceLoader::LoadOccluderGeometry(ModelResourceFile* file)
+{
+	if (file->m_IsOccluderGeometryKept)
+	{
+		return;
+	}
+	file->m_IsOccluderGeometryKept = true;
+
+	Assimp::Importer modelLoader;
+	const aiScene* scene = modelLoader.ReadFile(file->getPath().generic_string(), aiProcess_Triangulate | aiProcess_JoinIdenticalVertices);
+	if (!scene)
+	{
+		ERR("Occluder geometry could not be loaded: " + file->getPath().generic_string());
+		ERR("Assimp: " + modelLoader.GetErrorString());
+		return;
+	}
+
+	file->m_Positions.clear();
+	file->m_Indices.clear();
+	for (unsigned int i = 0; i < scene->mNumMeshes; i++)
+	{
+		AppendOccluderGeometry(file, scene->mMeshes[i]);
+	}
+}
+
 void ResourceLoader::LoadAssimp(ModelResourceFile* file)
 {
 	Assimp::Importer modelLoader;
@@ -48,20 +89,30 @@ void ResourceLoader::LoadAssimp(ModelResourceFile* file)
 	Vector<Ref<Texture>> textures;
 	textures.resize(scene->mNumTextures, nullptr);
 	file->m_Meshes.clear();
+	file->m_Positions.clear();
+	file->m_Indices.clear();
 	for (int i = 0; i < scene->mNumMeshes; i++)
 	{
 		const aiMesh* mesh = scene->mMeshes[i];
 
 		Vector<VertexData> vertices;
 		vertices.reserve(mesh->mNumVertices);
+		if (file->m_IsOccluderGeometryKept)
+		{
+			AppendOccluderGeometry(file, mesh);
+		}
 
 		VertexData vertex;
 		ZeroMemory(&vertex, sizeof(VertexData));
+		Vector3 lowerBounds(FLT_MAX);
+		Vector3 higherBounds(-FLT_MAX);
 		for (unsigned int v = 0; v < mesh->mNumVertices; v++)
 		{
 			vertex.m_Position.x = mesh->mVertices[v].x;
 			vertex.m_Position.y = mesh->mVertices[v].y;
 			vertex.m_Position.z = mesh->mVertices[v].z;
+			lowerBounds = Vector3::Min(lowerBounds, vertex.m_Position);
+			higherBounds = Vector3::Max(higherBounds, vertex.m_Position);
 
 			if (mesh->mNormals)
 			{
@@ -216,6 +267,14 @@ void ResourceLoader::LoadAssimp(ModelResourceFile* file)
 		Mesh extractedMesh;
 		extractedMesh.m_VertexBuffer.reset(new VertexBuffer(vertices));
 		extractedMesh.m_IndexBuffer.reset(new IndexBuffer(indices));
+		if (mesh->mNumVertices)
+		{
+			BoundingBox::CreateFromPoints(extractedMesh.m_BoundingBox, lowerBounds, higherBounds);
+		}
+		else
+		{
+			extractedMesh.m_BoundingBox = BoundingBox({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f });
+		}
 		
 		bool found = false;
 		for (auto& materialModels : file->getMeshes())
@@ -233,6 +292,24 @@ void ResourceLoader::LoadAssimp(ModelResourceFile* file)
 			file->getMeshes().push_back(Pair<Ref<Material>, Vector<Mesh>>(extractedMaterial, { extractedMesh }));
 		}
 	}
+
+	bool isFirstMesh = true;
+	file->m_BoundingBox = BoundingBox({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f });
+	for (auto& [material, meshes] : file->getMeshes())
+	{
+		for (auto& mesh : meshes)
+		{
+			if (isFirstMesh)
+			{
+				file->m_BoundingBox = mesh.m_BoundingBox;
+				isFirstMesh = false;
+			}
+			else
+			{
+				BoundingBox::CreateMerged(file->m_BoundingBox, file->m_BoundingBox, mesh.m_BoundingBox);
+			}
+		}
+	}
 }
 
 void ResourceLoader::LoadALUT(AudioResourceFile* audioRes, const char* audioBuffer, int format, int size, float frequency)
@@ -515,6 +592,7 @@ void ResourceLoader::ReloadResourceData(const String& path)
 		if (resData->getPath() == path)
 		{
 			*resData->getRawData() = buffer;
+			resFile->updateTrackedBytes();
 		}
 	}
 }
@@ -554,6 +632,7 @@ void ResourceLoader::Reload(AudioResourceFile* file)
 	    file->m_ResourceData->getRawData()->begin(),
 	    audioBuffer,
 	    audioBuffer + size);
+	file->updateTrackedBytes();
 
 	AudioResourceFile* audioRes = file;
 	LoadALUT(audioRes, audioBuffer, format, size, frequency);
@@ -52,6 +52,7 @@ class ResourceLoader
 	
 	static void UpdateFileTimes(ResourceFile* file);
 	static void LoadAssimp(ModelResourceFile* file);
+	static void AppendOccluderGeometry(ModelResourceFile* file, const aiMesh* mesh);
 	static void LoadALUT(AudioResourceFile* audioRes, const char* audioBuffer, int format, int size, float frequency);
 
 public:
@@ -82,6 +83,10 @@ public:
 	static void Reload(ImageResourceFile* file);
 	static void Reload(FontResourceFile* file);
 
+	/// Keep a CPU copy of the vertex positions and triangle indices of file, for rasterizing it as an occluder.
+	/// Imports the model again the first time, and keeps the copy up to date when the file is reloaded.
+	static void LoadOccluderGeometry(ModelResourceFile* file);
+
 	/// Load all the files passed in, in a parellel manner. Return total tasks generated.
 	static int Preload(Vector<String> paths, Atomic<int>& progress);
 	static void Unload(const Vector<String>& paths);
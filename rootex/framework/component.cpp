@@ -1,7 +1,12 @@
 #include "component.h"
 
+Atomic<ComponentVersion> Component::s_ChangeVersion = 0;
+
 Component::Component()
     : m_Owner(nullptr)
+    , m_RegistryIndex(0)
+    , m_IsRegistered(false)
+    , m_ChangeVersion(++s_ChangeVersion)
 {
 }
 
@@ -27,7 +32,22 @@ void Component::onTrigger()
 {
 }
 
-Ref<Entity> Component::getOwner() const
+void Component::markChanged()
+{
+	m_ChangeVersion = ++s_ChangeVersion;
+}
+
+ComponentVersion Component::GetCurrentChangeVersion()
+{
+	return s_ChangeVersion;
+}
+
+ComponentVersion Component::NewChangeVersion()
+{
+	return ++s_ChangeVersion;
+}
+
+Entity* Component::getOwner() const
 {
 	return m_Owner;
 }
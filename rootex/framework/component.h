@@ -3,21 +3,56 @@
 #include "common/common.h"
 #include "script/interpreter.h"
 #include "components/component_ids.h"
+#include "component_pool.h"
 
 typedef unsigned int ComponentID;
+/// Monotonic stamp of a change to component data. Later changes always receive larger versions.
+typedef unsigned long long ComponentVersion;
+
+/// Position of ComponentClass in the EntityFactory creator tables, assigned when the class is registered.
+/// Unlike a ComponentID, which several classes may share, it stands for exactly one class.
+template <class ComponentClass>
+struct ComponentCreatorIndex
+{
+	static inline size_t s_Value = (size_t)-1;
+};
 
 /// An ECS style interface of a collection of data that helps implement a behaviour. Also allows operations on that data.
 class Component
 {
-	void setOwner(Ref<Entity>& newOwner) { m_Owner = newOwner; }
+	void setOwner(Entity* newOwner) { m_Owner = newOwner; }
+	friend class Entity;
 	friend class EntityFactory;
+	friend class EntityCommandBuffer;
+
+	/// Position inside the System component list of this component's ID. Allows O(1) deregistration.
+	size_t m_RegistryIndex;
+	bool m_IsRegistered;
+	friend class System;
+
+	static Atomic<ComponentVersion> s_ChangeVersion;
+	ComponentVersion m_ChangeVersion;
 
 protected:
-	Ref<Entity> m_Owner;
+	/// Non-owning back pointer. Cleared when the component is removed or its Entity is destroyed,
+	/// since a Ref may keep the component alive for longer.
+	Entity* m_Owner;
+
+	/// Stamp this component with a fresh version. Call after every write that systems reading this component should react to.
+	void markChanged();
+	/// Stamp this component with a version reserved by NewChangeVersion(). Lets a pass over many components, possibly
+	/// on several threads, share one version instead of contending on the global counter.
+	void markChanged(ComponentVersion version) { m_ChangeVersion = version; }
 	
+
 public:
 	static const ComponentID s_ID = (ComponentID)ComponentIDs::Component;
 
+	/// Version of the latest change made to any component. Store this after processing to later ask hasChangedSince().
+	static ComponentVersion GetCurrentChangeVersion();
+	/// Reserve a fresh version for markChanged(ComponentVersion).
+	static ComponentVersion NewChangeVersion();
+
 	Component();
 	virtual ~Component();
 	
@@ -29,7 +64,12 @@ public:
 
 	virtual void onTrigger();
 
-	Ref<Entity> getOwner() const;
+	Entity* getOwner() const;
+	/// True while the component is attached to an entity and listed by System. ComponentPool iteration skips the others.
+	bool isRegistered() const { return m_IsRegistered; }
+	ComponentVersion getChangeVersion() const { return m_ChangeVersion; }
+	/// True if the component was changed after the moment GetCurrentChangeVersion() returned version.
+	bool hasChangedSince(ComponentVersion version) const { return m_ChangeVersion > version; }
 	virtual ComponentID getComponentID() const = 0;
 	virtual String getName() const = 0;
 	/// Get JSON representation of the component data needed to re-construct component from memory.
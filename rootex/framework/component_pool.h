@@ -0,0 +1,169 @@
+#pragma once
+
+#include "common/common.h"
+#include "core/memory_tracker.h"
+
+#include <array>
+
+/// Number of components of one type stored contiguously inside a single ComponentPool chunk.
+#define COMPONENT_POOL_CHUNK_SIZE 256
+
+/// Routes heap allocations of ComponentClass through ComponentPool<ComponentClass>. Place as the first line of the class body.
+#define DEFINE_COMPONENT_POOL(ComponentClass)                                                                      \
+public:                                                                                                            \
+	static void* operator new(size_t size) { return ComponentPool<ComponentClass>::GetSingleton()->allocate(size); } \
+	static void operator delete(void* component) { ComponentPool<ComponentClass>::GetSingleton()->deallocate(component); } \
+                                                                                                                   \
+private:
+
+/// Handle to a slot inside a ComponentPool. Stays the same for the whole lifetime of the component occupying it.
+typedef unsigned int ComponentPoolHandle;
+
+/// Contiguous, type specific storage for components.
+/// Components are laid out in fixed size chunks which never move, so pointers and handles stay stable while the pool grows.
+/// Freed slots are recycled before new chunks are allocated.
+template <class ComponentType>
+class ComponentPool
+{
+	struct Slot
+	{
+		alignas(ComponentType) unsigned char m_Storage[sizeof(ComponentType)];
+		ComponentPoolHandle m_Handle;
+		bool m_IsAlive;
+	};
+	typedef std::array<Slot, COMPONENT_POOL_CHUNK_SIZE> Chunk;
+
+	Vector<Ptr<Chunk>> m_Chunks;
+	Vector<ComponentPoolHandle> m_FreeHandles;
+	size_t m_Count;
+
+	/// Live components of this type.
+	MemoryCounter m_MemoryCounter;
+	/// Chunks reserved by this pool, live or not.
+	MemoryCounter m_ChunkMemoryCounter;
+
+	ComponentPool()
+	    : m_Count(0)
+	{
+	}
+	ComponentPool(ComponentPool&) = delete;
+	~ComponentPool() = default;
+
+	Slot& getSlot(ComponentPoolHandle handle) const { return (*m_Chunks[handle / COMPONENT_POOL_CHUNK_SIZE])[handle % COMPONENT_POOL_CHUNK_SIZE]; }
+	bool isRegistered(const Slot& slot) const { return slot.m_IsAlive && ((const ComponentType*)slot.m_Storage)->isRegistered(); }
+
+public:
+	/// Iterates over registered components in memory order.
+	/// Components still allocated because a Ref keeps them alive after being removed from their entity are skipped.
+	class Iterator
+	{
+		const ComponentPool* m_Pool;
+		ComponentPoolHandle m_Handle;
+
+		void skipUnregistered()
+		{
+			while (m_Handle < m_Pool->getCapacity() && !m_Pool->isRegistered(m_Pool->getSlot(m_Handle)))
+			{
+				m_Handle++;
+			}
+		}
+
+	public:
+		Iterator(const ComponentPool* pool, ComponentPoolHandle handle)
+		    : m_Pool(pool)
+		    , m_Handle(handle)
+		{
+			skipUnregistered();
+		}
+
+		ComponentType* operator*() const { return (ComponentType*)m_Pool->getSlot(m_Handle).m_Storage; }
+		Iterator& operator++()
+		{
+			m_Handle++;
+			skipUnregistered();
+			return *this;
+		}
+		bool operator!=(const Iterator& other) const { return m_Handle != other.m_Handle; }
+	};
+
+	/// Pools are never destroyed so that components released during static destruction still find their storage.
+	static ComponentPool* GetSingleton()
+	{
+		static ComponentPool* singleton = new ComponentPool();
+		return singleton;
+	}
+
+	/// Report the memory counters of this pool to the MemoryTracker under the component class name.
+	void registerMemoryCounters(const String& componentName)
+	{
+		MemoryTracker::GetSingleton()->registerCounter("Components", componentName, &m_MemoryCounter);
+		MemoryTracker::GetSingleton()->registerCounter("ComponentPools", componentName, &m_ChunkMemoryCounter);
+	}
+
+	void* allocate(size_t size)
+	{
+		PANIC(size != sizeof(ComponentType), "Component allocated from a pool of a different type. Is DEFINE_COMPONENT_POOL missing on a derived class?");
+
+		if (m_FreeHandles.empty())
+		{
+			ComponentPoolHandle firstHandle = getCapacity();
+			m_Chunks.emplace_back(new Chunk());
+			m_ChunkMemoryCounter.add(sizeof(Chunk));
+			for (ComponentPoolHandle handle = firstHandle + COMPONENT_POOL_CHUNK_SIZE; handle > firstHandle; handle--)
+			{
+				m_FreeHandles.push_back(handle - 1);
+			}
+		}
+
+		ComponentPoolHandle handle = m_FreeHandles.back();
+		m_FreeHandles.pop_back();
+
+		Slot& slot = getSlot(handle);
+		slot.m_Handle = handle;
+		slot.m_IsAlive = true;
+		m_Count++;
+		m_MemoryCounter.add(sizeof(ComponentType));
+
+		return slot.m_Storage;
+	}
+
+	void deallocate(void* component)
+	{
+		Slot* slot = (Slot*)component;
+		slot->m_IsAlive = false;
+		m_FreeHandles.push_back(slot->m_Handle);
+		m_Count--;
+		m_MemoryCounter.remove(sizeof(ComponentType));
+	}
+
+	/// Returns nullptr if the slot is not occupied.
+	ComponentType* get(ComponentPoolHandle handle) const
+	{
+		if (handle >= getCapacity() || !getSlot(handle).m_IsAlive)
+		{
+			return nullptr;
+		}
+		return (ComponentType*)getSlot(handle).m_Storage;
+	}
+	ComponentPoolHandle getHandle(const ComponentType* component) const { return ((const Slot*)component)->m_Handle; }
+
+	Iterator begin() const { return Iterator(this, 0); }
+	Iterator end() const { return Iterator(this, getCapacity()); }
+
+	/// Calls function(ComponentType*) on every registered component changed after version, in memory order.
+	template <class Function>
+	void forEachChangedSince(unsigned long long version, Function&& function) const
+	{
+		for (ComponentType* component : *this)
+		{
+			if (component->hasChangedSince(version))
+			{
+				function(component);
+			}
+		}
+	}
+
+	/// Allocated components, including the ones skipped by iteration for not being registered.
+	size_t getCount() const { return m_Count; }
+	ComponentPoolHandle getCapacity() const { return (ComponentPoolHandle)(m_Chunks.size() * COMPONENT_POOL_CHUNK_SIZE); }
+};
@@ -8,6 +8,7 @@ AudioComponent::AudioComponent(bool playOnStart, bool attenuation, AudioSource::
     , m_ReferenceDistance(referenceDistance)
     , m_MaxDistance(maxDistance)
     , m_TransformComponent(nullptr)
+    , m_PushedTransformVersion(0)
 {
 }
 
@@ -16,7 +17,7 @@ bool AudioComponent::setup()
 	bool status = true;
 	if (m_Owner)
 	{
-		m_TransformComponent = m_Owner->getComponent<TransformComponent>().get();
+		m_TransformComponent = m_Owner->getComponentPtr<TransformComponent>();
 
 		if (m_TransformComponent == nullptr)
 		{
@@ -50,12 +51,12 @@ JSON::json AudioComponent::getJSON() const
 	return j;
 }
 
-void AudioComponent::update()
+void AudioComponent::updatePosition(const TransformComponent* transform)
 {
-	m_TransformComponent = m_Owner->getComponent<TransformComponent>().get();
-	if (m_IsAttenuated)
+	if (m_IsAttenuated && transform->hasChangedSince(m_PushedTransformVersion))
 	{
-		getAudioSource()->setPosition(m_TransformComponent->getAbsoluteTransform().Translation());
+		getAudioSource()->setPosition(transform->getAbsolutePosition());
+		m_PushedTransformVersion = transform->getChangeVersion();
 	}
 }
 
@@ -64,7 +65,10 @@ void AudioComponent::update()
 void AudioComponent::draw()
 {
 	ImGui::Checkbox("Play on Start", &m_IsPlayOnStart);
-	ImGui::Checkbox("Turn on Attenuation", &m_IsAttenuated);
+	if (ImGui::Checkbox("Turn on Attenuation", &m_IsAttenuated))
+	{
+		m_PushedTransformVersion = 0;
+	}
 
 	if (ImGui::BeginCombo("Attenutation Model", m_AttenuationModelName.c_str()))
 	{
@@ -14,6 +14,8 @@ private:
 	ALfloat m_ReferenceDistance;
 	ALfloat m_MaxDistance;
 	AudioSource* m_AudioSource;
+	/// Transform version last sent to the audio source. Skips OpenAL position updates for sources that did not move.
+	ComponentVersion m_PushedTransformVersion;
 
 protected:
 	bool m_IsPlayOnStart;
@@ -32,7 +34,8 @@ public:
 
 	virtual bool setup() override;
 
-	void update();
+	/// Moves an attenuated audio source to transform if it moved since the last call.
+	void updatePosition(const TransformComponent* transform);
 
 	bool isPlayOnStart() const { return m_IsPlayOnStart; }
 	bool isAttenuated() { return m_IsAttenuated; }
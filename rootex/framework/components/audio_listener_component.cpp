@@ -47,5 +47,5 @@ void AudioListenerComponent::onRemove()
 
 Vector3 AudioListenerComponent::getPosition() const
 {
-	return m_TransformComponent->getAbsoluteTransform().Translation();
+	return m_TransformComponent->getAbsolutePosition();
 }
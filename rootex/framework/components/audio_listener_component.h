@@ -8,6 +8,8 @@ class TransformComponent;
 /// Useful for marking 3D sound attenuation in moving listeners
 class AudioListenerComponent : public Component
 {
+	DEFINE_COMPONENT_POOL(AudioListenerComponent);
+
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
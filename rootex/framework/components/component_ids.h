@@ -1,5 +1,7 @@
 #pragma once
 
+#include <bitset>
+
 enum class ComponentIDs : unsigned int
 {
 	Component,
@@ -28,5 +30,10 @@ enum class ComponentIDs : unsigned int
 	TransformAnimationComponent,
 	TriggerComponent,
 	SkyComponent,
-	FogComponent
+	FogComponent,
+	/// Number of distinct component IDs. Keep this last.
+	Count
 };
+
+/// Set of component types, one bit per ComponentIDs entry.
+typedef std::bitset<(size_t)ComponentIDs::Count> ComponentMask;
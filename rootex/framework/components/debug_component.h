@@ -4,6 +4,8 @@
 
 class DebugComponent : public Component
 {
+	DEFINE_COMPONENT_POOL(DebugComponent);
+
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
@@ -1,6 +1,7 @@
 #include "hierarchy_component.h"
 #include "entity_factory.h"
 #include "event_manager.h"
+#include "systems/hierarchy_system.h"
 
 Component* HierarchyComponent::Create(const JSON::json& componentData)
 {
@@ -34,14 +35,16 @@ HierarchyComponent::HierarchyComponent(EntityID parentID, const Vector<EntityID>
 {
 }
 
-bool HierarchyComponent::addChild(Ref<Entity> child)
+bool HierarchyComponent::addChild(Entity* child)
 {
 	if (auto&& findIt = std::find(m_ChildrenIDs.begin(), m_ChildrenIDs.end(), child->getID()) == m_ChildrenIDs.end())
 	{
-		m_Children.push_back(child->getComponent<HierarchyComponent>().get());
+		m_Children.push_back(child->getComponentPtr<HierarchyComponent>());
 		m_ChildrenIDs.push_back(child->getID());
-		child->getComponent<HierarchyComponent>()->m_Parent = this;
-		child->getComponent<HierarchyComponent>()->m_ParentID = this->m_Owner->getID();
+		child->getComponentPtr<HierarchyComponent>()->m_Parent = this;
+		child->getComponentPtr<HierarchyComponent>()->m_ParentID = this->m_Owner->getID();
+		child->getComponentPtr<HierarchyComponent>()->markChanged();
+		HierarchySystem::InvalidateHierarchy();
 		return true;
 	}
 	return false;
@@ -57,7 +60,8 @@ bool HierarchyComponent::setupEntities()
 			ERR("Could not find Entity with ID " + std::to_string(m_ParentID));
 			return false;
 		}
-		m_Parent = parent->getComponent<HierarchyComponent>().get();
+		m_Parent = parent->getComponentPtr<HierarchyComponent>();
+		markChanged();
 		if (m_ParentID == ROOT_ENTITY_ID)
 		{
 			Ref<Entity> root = EntityFactory::GetSingleton()->findEntity(ROOT_ENTITY_ID);
@@ -68,7 +72,7 @@ bool HierarchyComponent::setupEntities()
 			}
 			Ref<HierarchyComponent> rootHC = root->getComponent<HierarchyComponent>();
 			rootHC->m_ChildrenIDs.push_back(m_Owner->getID());
-			rootHC->m_Children.push_back(m_Owner->getComponent<HierarchyComponent>().get());
+			rootHC->m_Children.push_back(m_Owner->getComponentPtr<HierarchyComponent>());
 		}
 		for (EntityID childID : m_ChildrenIDs)
 		{
@@ -78,22 +82,25 @@ bool HierarchyComponent::setupEntities()
 				ERR("Could not find Entity with ID " + std::to_string(childID));
 				return false;
 			}
-			m_Children.push_back(child->getComponent<HierarchyComponent>().get());
+			m_Children.push_back(child->getComponentPtr<HierarchyComponent>());
 		}
+		HierarchySystem::InvalidateHierarchy();
 	}
 	return true;
 }
 
-bool HierarchyComponent::removeChild(Ref<Entity> node)
+bool HierarchyComponent::removeChild(Entity* node)
 {
 	auto& findIt = std::find(m_ChildrenIDs.begin(), m_ChildrenIDs.end(), node->getID());
 	if (findIt != m_ChildrenIDs.end())
 	{
-		Ref<HierarchyComponent> hc = node->getComponent<HierarchyComponent>();
+		HierarchyComponent* hc = node->getComponentPtr<HierarchyComponent>();
 		hc->m_Parent = nullptr;
 		hc->m_ParentID = INVALID_ID;
+		hc->markChanged();
+		HierarchySystem::InvalidateHierarchy();
 
-		auto&& findItPtr = std::find(m_Children.begin(), m_Children.end(), hc.get());
+		auto&& findItPtr = std::find(m_Children.begin(), m_Children.end(), hc);
 
 		m_Children.erase(findItPtr);
 		m_ChildrenIDs.erase(findIt);
@@ -103,9 +110,9 @@ bool HierarchyComponent::removeChild(Ref<Entity> node)
 	return false;
 }
 
-bool HierarchyComponent::snatchChild(Ref<Entity> node)
+bool HierarchyComponent::snatchChild(Entity* node)
 {
-	node->getComponent<HierarchyComponent>()->getParent()->removeChild(node);
+	node->getComponentPtr<HierarchyComponent>()->getParent()->removeChild(node);
 	bool status = addChild(node);
 
 	return status;
@@ -117,6 +124,8 @@ void HierarchyComponent::clear()
 	m_ParentID = INVALID_ID;
 	m_Children.clear();
 	m_ChildrenIDs.clear();
+	markChanged();
+	HierarchySystem::InvalidateHierarchy();
 }
 
 void HierarchyComponent::onRemove()
@@ -166,7 +175,7 @@ void HierarchyComponent::draw()
 			{
 				if (ImGui::Selectable(entity->getFullName().c_str()))
 				{
-					bool status = entity->getComponent<HierarchyComponent>()->snatchChild(getOwner());
+					bool status = entity->getComponentPtr<HierarchyComponent>()->snatchChild(getOwner());
 					PANIC(status == false, "Could not set parent as " + entity->getFullName() + " for entity " + getOwner()->getFullName());
 				}
 			}
@@ -175,7 +184,7 @@ void HierarchyComponent::draw()
 		ImGui::SameLine();
 		if (ImGui::Button("Parent")) // Not available for Root (Root.m_Parent is nullptr)
 		{
-			EventManager::GetSingleton()->call("OpenChildEntity", "EditorOpenEntity", m_Parent->getOwner());
+			EventManager::GetSingleton()->call("OpenChildEntity", "EditorOpenEntity", m_Parent->getOwner()->getHandle());
 		}
 	}
 
@@ -185,7 +194,7 @@ void HierarchyComponent::draw()
 		{
 			if (ImGui::Selectable(child->getOwner()->getFullName().c_str()))
 			{
-				EventManager::GetSingleton()->call("OpenChildEntity", "EditorOpenEntity", child->getOwner());
+				EventManager::GetSingleton()->call("OpenChildEntity", "EditorOpenEntity", child->getOwner()->getHandle());
 			}
 		}
 		ImGui::ListBoxFooter();
@@ -6,6 +6,8 @@
 
 class HierarchyComponent : public Component
 {
+	DEFINE_COMPONENT_POOL(HierarchyComponent);
+
 protected:
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
@@ -28,9 +30,9 @@ public:
 	virtual ~HierarchyComponent() = default;
 
 	virtual bool setupEntities() override;
-	virtual bool addChild(Ref<Entity> child);
-	virtual bool removeChild(Ref<Entity> node);
-	virtual bool snatchChild(Ref<Entity> node);
+	virtual bool addChild(Entity* child);
+	virtual bool removeChild(Entity* node);
+	virtual bool snatchChild(Entity* node);
 	void clear();
 
 	virtual void onRemove() override;
@@ -12,12 +12,12 @@ HierarchyGraph::~HierarchyGraph()
 {
 }
 
-bool HierarchyGraph::addChild(Ref<Entity> child)
+bool HierarchyGraph::addChild(Entity* child)
 {
 	return m_RootHierarchyComponent->addChild(child);
 }
 
-bool HierarchyGraph::removeChild(Ref<Entity> child)
+bool HierarchyGraph::removeChild(Entity* child)
 {
 	return m_RootHierarchyComponent->removeChild(child);
 }
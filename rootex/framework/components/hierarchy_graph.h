@@ -15,8 +15,8 @@ public:
 	HierarchyGraph(HierarchyGraph&) = delete;
 	~HierarchyGraph();
 	
-	bool addChild(Ref<Entity> child);
-	bool removeChild(Ref<Entity> child);
+	bool addChild(Entity* child);
+	bool removeChild(Entity* child);
 
 	Ref<Entity> getRootEntity() const { return m_Root; }
 	Ref<HierarchyComponent> getRootHierarchyComponent() const { return m_RootHierarchyComponent; }
@@ -50,7 +50,7 @@ bool MusicComponent::setup()
 	bool status = AudioComponent::setup();
 	if (m_Owner)
 	{
-		m_TransformComponent = m_Owner->getComponent<TransformComponent>().get();
+		m_TransformComponent = m_Owner->getComponentPtr<TransformComponent>();
 		if (m_TransformComponent == nullptr)
 		{
 			WARN("Entity without transform component!");
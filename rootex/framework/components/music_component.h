@@ -9,6 +9,8 @@
 
 class MusicComponent : public AudioComponent
 {
+	DEFINE_COMPONENT_POOL(MusicComponent);
+
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
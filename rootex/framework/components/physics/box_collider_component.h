@@ -8,6 +8,8 @@
 /// Takes box's dimensions and material type as arguments.
 class BoxColliderComponent : public PhysicsColliderComponent
 {
+	DEFINE_COMPONENT_POOL(BoxColliderComponent);
+
 	static Component* Create(const JSON::json& boxComponentData);
 	static Component* CreateDefault();
 
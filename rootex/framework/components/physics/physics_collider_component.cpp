@@ -44,7 +44,7 @@ bool PhysicsColliderComponent::setup()
 	bool status = true;
 	if (m_Owner)
 	{
-		m_TransformComponent = m_Owner->getComponent<TransformComponent>().get();
+		m_TransformComponent = m_Owner->getComponentPtr<TransformComponent>();
 		if (!m_TransformComponent)
 		{
 			ERR("TransformComponent not found on entity with PhysicsComponent: " + m_Owner->getFullName());
@@ -70,7 +70,7 @@ bool PhysicsColliderComponent::setup()
 				m_Body->setUserPointer(this);
 			}
 			
-			m_ScriptComponent = getOwner()->getComponent<ScriptComponent>().get();
+			m_ScriptComponent = getOwner()->getComponentPtr<ScriptComponent>();
 			if (m_IsGeneratesHitEvents && !m_ScriptComponent)
 			{
 				WARN("ScriptComponent not found on entity with a PhysicsComponent that generates hit events: " + m_Owner->getFullName());
@@ -93,7 +93,8 @@ void PhysicsColliderComponent::getWorldTransform(btTransform& worldTrans) const
 
 void PhysicsColliderComponent::setWorldTransform(const btTransform& worldTrans)
 {
-	m_TransformComponent->setRotationPosition(btTransformToMat(worldTrans));
+	btQuaternion rotation = worldTrans.getRotation();
+	m_TransformComponent->setPositionRotation(btVector3ToVec(worldTrans.getOrigin()), Quaternion(rotation.x(), rotation.y(), rotation.z(), rotation.w()));
 }
 
 void PhysicsColliderComponent::applyForce(const Vector3& force)
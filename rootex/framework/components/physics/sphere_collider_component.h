@@ -8,6 +8,8 @@
 /// Takes sphere's radius and material type as arguments. 
 class SphereColliderComponent : public PhysicsColliderComponent
 {
+	DEFINE_COMPONENT_POOL(SphereColliderComponent);
+
 	static Component* Create(const JSON::json& sphereComponentData);
 	static Component* CreateDefault();
 
@@ -11,6 +11,8 @@ class LuaTextResourceFile;
 
 class ScriptComponent : public Component
 {
+	DEFINE_COMPONENT_POOL(ScriptComponent);
+
 public:
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
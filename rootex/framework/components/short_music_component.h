@@ -9,6 +9,8 @@
 
 class ShortMusicComponent : public AudioComponent
 {
+	DEFINE_COMPONENT_POOL(ShortMusicComponent);
+
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
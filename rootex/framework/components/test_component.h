@@ -4,6 +4,8 @@
 
 class TestComponent : public Component
 {
+	DEFINE_COMPONENT_POOL(TestComponent);
+
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
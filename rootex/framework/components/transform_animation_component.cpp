@@ -56,7 +56,7 @@ TransformAnimationComponent::TransformAnimationComponent(const Vector<Keyframe>
 
 bool TransformAnimationComponent::setup()
 {
-	m_TransformComponent = m_Owner->getComponent<TransformComponent>().get();
+	m_TransformComponent = m_Owner->getComponentPtr<TransformComponent>();
 	if (!m_TransformComponent)
 	{
 		WARN("TransformComponent not found on entity with TransformAnimationComponent: " + m_Owner->getFullName());
@@ -108,62 +108,59 @@ void TransformAnimationComponent::reset()
 	interpolate(0.0f);
 }
 
-void TransformAnimationComponent::interpolate(float t)
+bool TransformAnimationComponent::sample(float t, Vector3& translation, Quaternion& rotation, Vector3& scale) const
 {
 	if (t <= getStartTime())
 	{
-		m_TransformComponent->setTransform(DirectX::XMMatrixAffineTransformation(
-		    m_Keyframes.front().m_Scale,
-		    Vector3::Zero,
-		    m_Keyframes.front().m_Rotation,
-		    m_Keyframes.front().m_Translation));
+		translation = m_Keyframes.front().m_Translation;
+		rotation = m_Keyframes.front().m_Rotation;
+		scale = m_Keyframes.front().m_Scale;
+		return true;
 	}
-	else if (t >= getEndTime())
+	if (t >= getEndTime())
 	{
-		m_TransformComponent->setTransform(DirectX::XMMatrixAffineTransformation(
-		    m_Keyframes.back().m_Scale,
-		    Vector4::Zero,
-		    m_Keyframes.back().m_Rotation,
-		    m_Keyframes.back().m_Translation));
+		translation = m_Keyframes.back().m_Translation;
+		rotation = m_Keyframes.back().m_Rotation;
+		scale = m_Keyframes.back().m_Scale;
+		return true;
 	}
-	else
-	{
-		Vector3 translation = Vector3::Zero;
-		Quaternion rotation = Quaternion::Identity;
-		Vector3 scale = { 1.0f, 1.0f, 1.0f };
 
-		for (unsigned int i = 0; i < m_Keyframes.size() - 1; i++)
+	for (unsigned int i = 0; i < m_Keyframes.size() - 1; i++)
+	{
+		if (t > m_Keyframes[i].m_TimePosition && t < m_Keyframes[i + 1].m_TimePosition)
 		{
-			if (t > m_Keyframes[i].m_TimePosition && t < m_Keyframes[i + 1].m_TimePosition)
-			{
-				float timeSinceMostRecentKeyframe = t - m_Keyframes[i].m_TimePosition;
-				float timeBetween = m_Keyframes[i + 1].m_TimePosition - m_Keyframes[i].m_TimePosition;
-				float lerpFactor = timeSinceMostRecentKeyframe / timeBetween;
-
-				translation = Vector3::Lerp(
-				    m_Keyframes[i].m_Translation,
-				    m_Keyframes[i + 1].m_Translation,
-				    lerpFactor);
-				rotation = Quaternion::Slerp(
-				    m_Keyframes[i].m_Rotation,
-				    m_Keyframes[i + 1].m_Rotation,
-				    lerpFactor);
-				scale = Vector3::Lerp(
-				    m_Keyframes[i].m_Scale,
-				    m_Keyframes[i + 1].m_Scale,
-				    lerpFactor);
-		
-				m_TransformComponent->setTransform(DirectX::XMMatrixAffineTransformation(
-					scale,
-					Vector4::Zero,
-					rotation,
-					translation));
-				
-				// No need to check futher. This will be the only one needed.
-				break;
-			}
+			float timeSinceMostRecentKeyframe = t - m_Keyframes[i].m_TimePosition;
+			float timeBetween = m_Keyframes[i + 1].m_TimePosition - m_Keyframes[i].m_TimePosition;
+			float lerpFactor = timeSinceMostRecentKeyframe / timeBetween;
+
+			translation = Vector3::Lerp(
+			    m_Keyframes[i].m_Translation,
+			    m_Keyframes[i + 1].m_Translation,
+			    lerpFactor);
+			rotation = Quaternion::Slerp(
+			    m_Keyframes[i].m_Rotation,
+			    m_Keyframes[i + 1].m_Rotation,
+			    lerpFactor);
+			scale = Vector3::Lerp(
+			    m_Keyframes[i].m_Scale,
+			    m_Keyframes[i + 1].m_Scale,
+			    lerpFactor);
+
+			// No need to check futher. This will be the only one needed.
+			return true;
 		}
+	}
+	return false;
+}
 
+void TransformAnimationComponent::interpolate(float t)
+{
+	Vector3 translation;
+	Quaternion rotation;
+	Vector3 scale;
+	if (sample(t, translation, rotation, scale))
+	{
+		m_TransformComponent->setPositionRotationScale(translation, rotation, scale);
 	}
 }
 
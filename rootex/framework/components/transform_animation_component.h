@@ -6,6 +6,8 @@ class TransformComponent;
 
 class TransformAnimationComponent : public Component
 {
+	DEFINE_COMPONENT_POOL(TransformAnimationComponent);
+
 public:
 	struct Keyframe
 	{
@@ -54,6 +56,8 @@ public:
 	float getEndTime() const;
 	void reset();
 
+	/// Finds the keyframe blend at time t. Returns false if t lands exactly on an inner keyframe, matching interpolate() leaving the transform untouched.
+	bool sample(float t, Vector3& translation, Quaternion& rotation, Vector3& scale) const;
 	void interpolate(float t);
 
 	void setPlaying(bool enabled);
@@ -4,6 +4,9 @@
 #include <math.h>
 
 #include "entity.h"
+#include "systems/hierarchy_system.h"
+#include "systems/spatial_system.h"
+#include "transform_batch.h"
 
 Component* TransformComponent::Create(const JSON::json& componentData)
 {
@@ -33,17 +36,47 @@ Component* TransformComponent::CreateDefault()
 	return transformComponent;
 }
 
+void TransformComponent::onTransformChanged()
+{
+	m_IsAbsoluteTransformCached = false;
+	markChanged();
+}
+
+void TransformComponent::cacheAbsoluteTransform()
+{
+	m_AbsoluteTransform = computeAbsoluteTransform();
+	m_AbsoluteRotationPosition = computeRotationPosition();
+	m_WorldBounds = computeWorldBounds(m_AbsoluteTransform);
+	m_IsAbsoluteTransformCached = true;
+}
+
+BoundingBox TransformComponent::computeWorldBounds(const Matrix& absoluteTransform) const
+{
+	BoundingBox worldBounds;
+	m_TransformBuffer.m_BoundingBox.Transform(worldBounds, absoluteTransform);
+	return worldBounds;
+}
+
 void TransformComponent::updateTransformFromPositionRotationScale()
 {
-	m_TransformBuffer.m_Transform = Matrix::Identity;
-	m_TransformBuffer.m_Transform = Matrix::CreateTranslation(m_TransformBuffer.m_Position) * m_TransformBuffer.m_Transform;
-	m_TransformBuffer.m_Transform = Matrix::CreateFromQuaternion(m_TransformBuffer.m_Rotation) * m_TransformBuffer.m_Transform;
-	m_TransformBuffer.m_Transform = Matrix::CreateScale(m_TransformBuffer.m_Scale) * m_TransformBuffer.m_Transform;
+	TransformBatch::Compose(m_TransformBuffer.m_Position, m_TransformBuffer.m_Rotation, m_TransformBuffer.m_Scale, m_TransformBuffer.m_Transform);
+	onTransformChanged();
 }
 
 void TransformComponent::updatePositionRotationScaleFromTransform(Matrix& transform)
 {
 	transform.Decompose(m_TransformBuffer.m_Scale, m_TransformBuffer.m_Rotation, m_TransformBuffer.m_Position);
+	onTransformChanged();
+}
+
+void TransformComponent::setParentAbsoluteTransform(const Matrix& parentAbsoluteTransform, ComponentVersion version)
+{
+	if (m_ParentAbsoluteTransform != parentAbsoluteTransform)
+	{
+		m_ParentAbsoluteTransform = parentAbsoluteTransform;
+		m_IsAbsoluteTransformCached = false;
+		markChanged(version);
+	}
 }
 
 TransformComponent::TransformComponent(const Vector3& position, const Vector4& rotation, const Vector3& scale, const BoundingBox& bounds)
@@ -54,12 +87,22 @@ TransformComponent::TransformComponent(const Vector3& position, const Vector4& r
 	m_TransformBuffer.m_BoundingBox = bounds;
 
 	updateTransformFromPositionRotationScale();
+	HierarchySystem::InvalidateHierarchy();
 
 #ifdef ROOTEX_EDITOR
 	m_EditorRotation = { 0.0f, 0.0f, 0.0f };
 #endif // ROOTEX_EDITOR
 }
 
+void TransformComponent::onRemove()
+{
+	HierarchySystem::InvalidateHierarchy();
+	if (m_SpatialProxy >= 0)
+	{
+		SpatialSystem::GetSingleton()->removeTransform(this);
+	}
+}
+
 void TransformComponent::RegisterAPI(sol::table& rootex)
 {
 	sol::usertype<TransformComponent> transformComponent = rootex.new_usertype<TransformComponent>(
@@ -77,6 +120,11 @@ void TransformComponent::RegisterAPI(sol::table& rootex)
 	transformComponent["getScale"] = &TransformComponent::getScale;
 	transformComponent["getLocalTransform"] = &TransformComponent::getLocalTransform;
 	transformComponent["getParentAbsoluteTransform"] = &TransformComponent::getParentAbsoluteTransform;
+	transformComponent["getAbsoluteTransform"] = &TransformComponent::getAbsoluteTransform;
+	transformComponent["getAbsolutePosition"] = &TransformComponent::getAbsolutePosition;
+	transformComponent["getWorldBounds"] = &TransformComponent::getWorldBounds;
+	transformComponent["getHierarchyBounds"] = &TransformComponent::getHierarchyBounds;
+	transformComponent["hasHierarchyBounds"] = &TransformComponent::hasHierarchyBounds;
 	transformComponent["getComponentID"] = &TransformComponent::getComponentID;
 	transformComponent["getName"] = &TransformComponent::getName;
 }
@@ -105,6 +153,30 @@ void TransformComponent::setScale(const Vector3& scale)
 	updateTransformFromPositionRotationScale();
 }
 
+void TransformComponent::setPositionRotation(const Vector3& position, const Quaternion& rotation)
+{
+	m_TransformBuffer.m_Position = position;
+	m_TransformBuffer.m_Rotation = rotation;
+	updateTransformFromPositionRotationScale();
+}
+
+void TransformComponent::setPositionRotationScale(const Vector3& position, const Quaternion& rotation, const Vector3& scale)
+{
+	m_TransformBuffer.m_Position = position;
+	m_TransformBuffer.m_Rotation = rotation;
+	m_TransformBuffer.m_Scale = scale;
+	updateTransformFromPositionRotationScale();
+}
+
+void TransformComponent::setComposedTransform(const Vector3& position, const Quaternion& rotation, const Vector3& scale, const Matrix& localTransform)
+{
+	m_TransformBuffer.m_Position = position;
+	m_TransformBuffer.m_Rotation = rotation;
+	m_TransformBuffer.m_Scale = scale;
+	m_TransformBuffer.m_Transform = localTransform;
+	onTransformChanged();
+}
+
 void TransformComponent::setTransform(const Matrix& transform)
 {
 	m_TransformBuffer.m_Transform = transform;
@@ -114,6 +186,8 @@ void TransformComponent::setTransform(const Matrix& transform)
 void TransformComponent::setBounds(const BoundingBox& bounds)
 {
 	m_TransformBuffer.m_BoundingBox = bounds;
+	m_IsBoundsFitted = true;
+	onTransformChanged();
 }
 
 void TransformComponent::setRotationPosition(const Matrix& transform)
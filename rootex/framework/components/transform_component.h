@@ -5,6 +5,8 @@
 
 class TransformComponent : public Component
 {
+	DEFINE_COMPONENT_POOL(TransformComponent);
+
 public:
 	struct Bounds
 	{
@@ -30,16 +32,42 @@ private:
 	Matrix m_ParentAbsoluteTransform;
 	bool m_LockScale = false;
 
+	/// World matrices and bounds cached by the HierarchySystem transform pass. Getters compute them on the spot while the cache is stale.
+	Matrix m_AbsoluteTransform;
+	Matrix m_AbsoluteRotationPosition;
+	BoundingBox m_WorldBounds;
+	/// World bounds enclosing this transform and every transform below it, refreshed by the HierarchySystem transform pass.
+	BoundingBox m_HierarchyBounds;
+	/// False while no transform in this subtree has fitted bounds, which leaves m_HierarchyBounds meaningless.
+	bool m_HasHierarchyBounds = false;
+	/// Set once the bounds are fitted to something, like the model of a ModelComponent. Only fitted bounds are merged into hierarchy bounds.
+	bool m_IsBoundsFitted = false;
+	bool m_IsAbsoluteTransformCached = false;
+
+	/// Leaf of this transform in the SpatialSystem tree. Negative until the first SpatialSystem::updateBounds().
+	int m_SpatialProxy = -1;
+
 	const TransformBuffer* getTransformBuffer() const { return &m_TransformBuffer; };
 
+	Matrix computeAbsoluteTransform() const { return m_TransformBuffer.m_Transform * m_ParentAbsoluteTransform; }
+	Matrix computeRotationPosition() const { return Matrix::CreateFromQuaternion(m_TransformBuffer.m_Rotation) * Matrix::CreateTranslation(m_TransformBuffer.m_Position) * m_ParentAbsoluteTransform; }
+	BoundingBox computeWorldBounds(const Matrix& absoluteTransform) const;
+	/// Drops the cached world matrices and stamps a new change version. Call after any change to the local or parent transform.
+	void onTransformChanged();
+	void cacheAbsoluteTransform();
+
 	void updateTransformFromPositionRotationScale();
 	void updatePositionRotationScaleFromTransform(Matrix& transform);
+	/// Marks the transform changed with version if the parent transform differs.
+	void setParentAbsoluteTransform(const Matrix& parentAbsoluteTransform, ComponentVersion version);
 
 	TransformComponent(const Vector3& position, const Vector4& rotation, const Vector3& scale, const BoundingBox& bounds);
 	TransformComponent(TransformComponent&) = delete;
 
 	friend class ModelComponent;
 	friend class RenderSystem;
+	friend class HierarchySystem;
+	friend class SpatialSystem;
 	friend class EntityFactory;
 
 #ifdef ROOTEX_EDITOR
@@ -55,11 +83,18 @@ public:
 
 	virtual ~TransformComponent() = default;
 
+	virtual void onRemove() override;
+
 	void setPosition(const Vector3& position);
 	void setRotation(const float& yaw, const float& pitch, const float& roll);
 	void setRotationQuaternion(const Quaternion& rotation);
 	void setScale(const Vector3& scale);
+	void setPositionRotation(const Vector3& position, const Quaternion& rotation);
+	void setPositionRotationScale(const Vector3& position, const Quaternion& rotation, const Vector3& scale);
+	/// Write-back for matrices already composed by a TransformBatch. localTransform must be the composition of position, rotation and scale.
+	void setComposedTransform(const Vector3& position, const Quaternion& rotation, const Vector3& scale, const Matrix& localTransform);
 	void setTransform(const Matrix& transform);
+	/// Fits the bounds to the contents of the entity, which includes them in the hierarchy bounds of every ancestor.
 	void setBounds(const BoundingBox& bounds);
 	void setRotationPosition(const Matrix& transform);
 	
@@ -71,8 +106,17 @@ public:
 	const Quaternion& getRotation() const { return m_TransformBuffer.m_Rotation; }
 	const Vector3& getScale() const { return m_TransformBuffer.m_Scale; }
 	const Matrix& getLocalTransform() const { return m_TransformBuffer.m_Transform; }
-	Matrix getRotationPosition() const { return Matrix::CreateFromQuaternion(m_TransformBuffer.m_Rotation) * Matrix::CreateTranslation(m_TransformBuffer.m_Position) * m_ParentAbsoluteTransform; }
-	Matrix getAbsoluteTransform() const { return m_TransformBuffer.m_Transform * m_ParentAbsoluteTransform; }
+	/// World transform without the local scale.
+	Matrix getRotationPosition() const { return m_IsAbsoluteTransformCached ? m_AbsoluteRotationPosition : computeRotationPosition(); }
+	Matrix getAbsoluteTransform() const { return m_IsAbsoluteTransformCached ? m_AbsoluteTransform : computeAbsoluteTransform(); }
+	Vector3 getAbsolutePosition() const { return m_IsAbsoluteTransformCached ? m_AbsoluteTransform.Translation() : computeAbsoluteTransform().Translation(); }
+	/// Bounds transformed by the world transform, as an axis aligned box in world space.
+	BoundingBox getWorldBounds() const { return m_IsAbsoluteTransformCached ? m_WorldBounds : computeWorldBounds(computeAbsoluteTransform()); }
+	/// Fitted world bounds of this transform merged with the hierarchy bounds of its children, as of the last HierarchySystem transform pass.
+	const BoundingBox& getHierarchyBounds() const { return m_HierarchyBounds; }
+	/// False if no transform in this subtree has fitted bounds, in which case getHierarchyBounds() encloses nothing.
+	bool hasHierarchyBounds() const { return m_HasHierarchyBounds; }
+	bool isBoundsFitted() const { return m_IsBoundsFitted; }
 	Matrix getParentAbsoluteTransform() const { return m_ParentAbsoluteTransform; }
 	ComponentID getComponentID() const override { return s_ID; }
 	virtual String getName() const override { return "TransformComponent"; }
@@ -29,31 +29,40 @@ bool TriggerComponent::setupEntities()
 			return false;
 		}
 
-		m_TargetEntityTrigger = targetEntity->getComponent<TriggerComponent>();
-		if (!m_TargetEntityTrigger)
+		if (!targetEntity->hasComponent(TriggerComponent::s_ID))
 		{
-			ERR("TriggerComponent target " + m_Owner->getFullName() + " does not have a TriggerComponent");
+			ERR("TriggerComponent target " + targetEntity->getFullName() + " does not have a TriggerComponent");
 			return false;
 		}
+		m_TargetEntity = targetEntity->getHandle();
 	}
 	return true;
 }
 
-void TriggerComponent::setTarget(Ref<Entity> entity)
+void TriggerComponent::setTarget(Entity* entity)
 {
-	m_TargetEntityTrigger = entity->getComponent<TriggerComponent>();
-
-	if (m_TargetEntityTrigger)
+	if (entity->hasComponent(TriggerComponent::s_ID))
 	{
+		m_TargetEntity = entity->getHandle();
 		m_TargetEntityID = entity->getID();
 	}
 	else
 	{
 		WARN("TriggerComponent not found on new target for entity " + m_Owner->getFullName());
+		m_TargetEntity = {};
 		m_TargetEntityID = INVALID_ID;
 	}
 }
 
+TriggerComponent* TriggerComponent::getTarget() const
+{
+	if (Entity* targetEntity = EntityFactory::GetSingleton()->resolveEntity(m_TargetEntity))
+	{
+		return targetEntity->getComponentPtr<TriggerComponent>();
+	}
+	return nullptr;
+}
+
 void TriggerComponent::trigger()
 {
 	for (auto& component : m_Owner->getAllComponents())
@@ -61,9 +70,9 @@ void TriggerComponent::trigger()
 		component.second->onTrigger();
 	}
 	
-	if (m_TargetEntityTrigger)
+	if (TriggerComponent* target = getTarget())
 	{
-		m_TargetEntityTrigger->trigger();
+		target->trigger();
 	}
 }
 
@@ -84,27 +93,28 @@ void TriggerComponent::draw()
 	static bool showTarget = false;
 	ImGui::Checkbox("Show Target", &showTarget);
 
-	if (m_TargetEntityTrigger && showTarget)
+	TriggerComponent* target = getTarget();
+	if (target && showTarget)
 	{
-		TransformComponent* targetTransform = m_TargetEntityTrigger->getOwner()->getComponent<TransformComponent>().get();
-		TransformComponent* triggerTransform = getOwner()->getComponent<TransformComponent>().get();
+		TransformComponent* targetTransform = target->getOwner()->getComponentPtr<TransformComponent>();
+		TransformComponent* triggerTransform = getOwner()->getComponentPtr<TransformComponent>();
 
 		if (targetTransform && triggerTransform)
 		{
 			RenderSystem::GetSingleton()->submitLine(
-				triggerTransform->getAbsoluteTransform().Translation(), 
-				targetTransform->getAbsoluteTransform().Translation());
+				triggerTransform->getAbsolutePosition(), 
+				targetTransform->getAbsolutePosition());
 		}
 	}
 
-	String preview = m_TargetEntityTrigger ? m_TargetEntityTrigger->getOwner()->getFullName(): "None";
+	String preview = target ? target->getOwner()->getFullName() : "None";
 	if (ImGui::BeginCombo("Target", preview.c_str()))
 	{
 		for (auto& entity : EntityFactory::GetSingleton()->getEntities())
 		{
 			if (ImGui::Selectable(entity.second->getFullName().c_str()))
 			{
-				setTarget(entity.second);
+				setTarget(entity.second.get());
 			}
 		}
 
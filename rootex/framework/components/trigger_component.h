@@ -5,12 +5,14 @@
 
 class TriggerComponent : public Component
 {
+	DEFINE_COMPONENT_POOL(TriggerComponent);
+
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
 	friend class EntityFactory;
 
-	Ref<TriggerComponent> m_TargetEntityTrigger;
+	EntityHandle m_TargetEntity;
 	EntityID m_TargetEntityID;
 
 	TriggerComponent(EntityID targetEntity);
@@ -23,7 +25,9 @@ public:
 	virtual bool setupEntities() override;
 
 	void trigger();
-	void setTarget(Ref<Entity> entity);
+	void setTarget(Entity* entity);
+	/// Returns nullptr if there is no target or the target entity has been destroyed.
+	TriggerComponent* getTarget() const;
 
 	virtual String getName() const override { return "TriggerComponent"; }
 	ComponentID getComponentID() const { return s_ID; }
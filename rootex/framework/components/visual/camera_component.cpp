@@ -56,7 +56,7 @@ bool CameraComponent::setup()
 {
 	if (m_Owner)
 	{
-		m_TransformComponent = m_Owner->getComponent<TransformComponent>().get();
+		m_TransformComponent = m_Owner->getComponentPtr<TransformComponent>();
 		if (m_TransformComponent == nullptr)
 		{
 			return false;
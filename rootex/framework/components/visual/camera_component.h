@@ -5,6 +5,8 @@
 
 class CameraComponent : public Component
 {
+	DEFINE_COMPONENT_POOL(CameraComponent);
+
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
@@ -33,7 +35,7 @@ public:
 	TransformComponent* getTransformComponent() { return m_TransformComponent; }
 	virtual const Matrix& getViewMatrix();
 	virtual const Matrix& getProjectionMatrix();
-	Vector3 getAbsolutePosition() const { return m_TransformComponent->getAbsoluteTransform().Translation(); }
+	Vector3 getAbsolutePosition() const { return m_TransformComponent->getAbsolutePosition(); }
 	virtual String getName() const override { return "CameraComponent"; }
 
 	static const ComponentID s_ID = (ComponentID)ComponentIDs::CameraComponent;
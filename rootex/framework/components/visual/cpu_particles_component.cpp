@@ -1,10 +1,12 @@
 #include "cpu_particles_component.h"
 
-#include "random.h"
 #include "resource_loader.h"
 #include "systems/render_system.h"
+#include "render_queue.h"
 #include "timer.h"
 
+#include <xmmintrin.h>
+
 #include "renderer/material_library.h"
 
 Component* CPUParticlesComponent::Create(const JSON::json& componentData)
@@ -72,16 +74,20 @@ CPUParticlesComponent::CPUParticlesComponent(size_t poolSize, const String& part
     , m_TransformComponent(nullptr)
     , m_CurrentEmitMode(emitMode)
     , m_EmitterDimensions(emitterDimensions)
+    , m_PoolSize(0)
+    , m_AliveCount(0)
+    , m_RandomState(1)
 {
 	m_AllowedMaterials = { BasicMaterial::s_MaterialName };
 	expandPool(poolSize);
-	m_LastRenderTimePoint = std::chrono::high_resolution_clock::now();
 	m_EmitRate = 0;
 }
 
 bool CPUParticlesComponent::setup()
 {
-	m_TransformComponent = m_Owner->getComponent<TransformComponent>().get();
+	m_TransformComponent = m_Owner->getComponentPtr<TransformComponent>();
+	// xorshift never leaves a zero state
+	m_RandomState = (unsigned int)m_Owner->getID() * 2654435761u | 1u;
 	if (!m_TransformComponent)
 	{
 		ERR("Transform Component not found on entity with CPU Particles Component: " + m_Owner->getFullName());
@@ -90,112 +96,203 @@ bool CPUParticlesComponent::setup()
 	return true;
 }
 
-bool CPUParticlesComponent::preRender()
+void CPUParticlesComponent::submit(RenderQueue& queue)
 {
-	ModelComponent::preRender();
+	queue.submitCustom(this, m_BasicMaterial.get(), m_TransformComponent->getAbsolutePosition());
+}
+
+/// Adds rate * delta to 4 values at once.
+static void Integrate(float* values, const float* rates, __m128 delta)
+{
+	_mm_storeu_ps(values, _mm_add_ps(_mm_loadu_ps(values), _mm_mul_ps(_mm_loadu_ps(rates), delta)));
+}
 
-	int i = m_EmitRate;
-	while (i >= 0)
+void CPUParticlesComponent::emitParticles()
+{
+	for (int i = 0; i <= m_EmitRate; i++)
 	{
 		emit(m_ParticleTemplate);
-		i--;
 	}
+}
 
-	for (auto& particle : m_ParticlePool)
+void CPUParticlesComponent::simulate(size_t begin, size_t end, float deltaSeconds)
+{
+	// Lanes past the live particles hold dead ones, which are safe to update along with them
+	const __m128 delta = _mm_set1_ps(deltaSeconds);
+	const __m128 one = _mm_set1_ps(1.0f);
+	for (size_t i = begin; i < end; i += 4)
 	{
-		if (particle.m_LifeRemaining <= 0.0f)
+		Integrate(&m_PositionX[i], &m_VelocityX[i], delta);
+		Integrate(&m_PositionY[i], &m_VelocityY[i], delta);
+		Integrate(&m_PositionZ[i], &m_VelocityZ[i], delta);
+		Integrate(&m_RotationX[i], &m_AngularVelocityX[i], delta);
+		Integrate(&m_RotationY[i], &m_AngularVelocityY[i], delta);
+		Integrate(&m_RotationZ[i], &m_AngularVelocityZ[i], delta);
+		const __m128 lifeRemaining = _mm_sub_ps(_mm_loadu_ps(&m_LifeRemaining[i]), delta);
+		_mm_storeu_ps(&m_LifeRemaining[i], lifeRemaining);
+
+		// Instance data is written here so that render() only has to upload it
+		alignas(16) float life[4];
+		alignas(16) float size[4];
+		alignas(16) float sinYaw[4], cosYaw[4], sinPitch[4], cosPitch[4], sinRoll[4], cosRoll[4];
+		const __m128 lifeFraction = _mm_mul_ps(lifeRemaining, _mm_loadu_ps(&m_InverseLifeTime[i]));
+		_mm_store_ps(life, lifeFraction);
+		_mm_store_ps(size, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&m_SizeBegin[i]), lifeFraction), _mm_mul_ps(_mm_loadu_ps(&m_SizeEnd[i]), _mm_sub_ps(one, lifeFraction))));
+		DirectX::XMVECTOR sine;
+		DirectX::XMVECTOR cosine;
+		DirectX::XMVectorSinCos(&sine, &cosine, _mm_loadu_ps(&m_RotationX[i]));
+		_mm_store_ps(sinYaw, sine);
+		_mm_store_ps(cosYaw, cosine);
+		DirectX::XMVectorSinCos(&sine, &cosine, _mm_loadu_ps(&m_RotationY[i]));
+		_mm_store_ps(sinPitch, sine);
+		_mm_store_ps(cosPitch, cosine);
+		DirectX::XMVectorSinCos(&sine, &cosine, _mm_loadu_ps(&m_RotationZ[i]));
+		_mm_store_ps(sinRoll, sine);
+		_mm_store_ps(cosRoll, cosine);
+
+		for (size_t lane = 0; lane < 4; lane++)
 		{
-			particle.m_IsActive = false;
-			continue;
+			const float sy = sinYaw[lane], cy = cosYaw[lane];
+			const float sp = sinPitch[lane], cp = cosPitch[lane];
+			const float sr = sinRoll[lane], cr = cosRoll[lane];
+			// Same matrix as Matrix::CreateFromYawPitchRoll(m_RotationX, m_RotationY, m_RotationZ)
+			// A rotation is its own inverse transpose, and uniform scale does not turn normals, even at size 0
+			const Matrix rotation(
+			    cr * cy + sr * sp * sy, sr * cp, sr * sp * cy - cr * sy, 0.0f,
+			    cr * sp * sy - sr * cy, cr * cp, sr * sy + cr * sp * cy, 0.0f,
+			    cp * sy, -sp, cp * cy, 0.0f,
+			    0.0f, 0.0f, 0.0f, 1.0f);
+			Matrix transform = Matrix::CreateScale(size[lane]) * rotation;
+			transform.Translation({ m_PositionX[i + lane], m_PositionY[i + lane], m_PositionZ[i + lane] });
+			m_InstanceData[i + lane] = { transform, rotation, Color::Lerp(m_ColorEnd[i + lane], m_ColorBegin[i + lane], life[lane]) };
 		}
-		if (!particle.m_IsActive)
+	}
+}
+
+void CPUParticlesComponent::removeDead()
+{
+	size_t i = 0;
+	while (i < m_AliveCount)
+	{
+		if (m_LifeRemaining[i] <= 0.0f)
 		{
-			continue;
+			kill(i);
+		}
+		else
+		{
+			i++;
 		}
-
-		float delta = (std::chrono::high_resolution_clock::now() - m_LastRenderTimePoint).count() * (NS_TO_MS * MS_TO_S);
-		particle.m_LifeRemaining -= delta;
-		particle.m_Transform = Matrix::CreateTranslation(particle.m_Velocity * delta) * Matrix::CreateFromYawPitchRoll(particle.m_AngularVelocity.x * delta, particle.m_AngularVelocity.y * delta, particle.m_AngularVelocity.z * delta) * particle.m_Transform;
 	}
+}
 
-	return true;
+void CPUParticlesComponent::kill(size_t index)
+{
+	const size_t last = --m_AliveCount;
+	m_PositionX[index] = m_PositionX[last];
+	m_PositionY[index] = m_PositionY[last];
+	m_PositionZ[index] = m_PositionZ[last];
+	m_VelocityX[index] = m_VelocityX[last];
+	m_VelocityY[index] = m_VelocityY[last];
+	m_VelocityZ[index] = m_VelocityZ[last];
+	m_RotationX[index] = m_RotationX[last];
+	m_RotationY[index] = m_RotationY[last];
+	m_RotationZ[index] = m_RotationZ[last];
+	m_AngularVelocityX[index] = m_AngularVelocityX[last];
+	m_AngularVelocityY[index] = m_AngularVelocityY[last];
+	m_AngularVelocityZ[index] = m_AngularVelocityZ[last];
+	m_LifeRemaining[index] = m_LifeRemaining[last];
+	m_InverseLifeTime[index] = m_InverseLifeTime[last];
+	m_SizeBegin[index] = m_SizeBegin[last];
+	m_SizeEnd[index] = m_SizeEnd[last];
+	m_ColorBegin[index] = m_ColorBegin[last];
+	m_ColorEnd[index] = m_ColorEnd[last];
+	m_InstanceData[index] = m_InstanceData[last];
 }
 
 void CPUParticlesComponent::render()
 {
-	for (auto& particle : m_ParticlePool)
+	if (m_AliveCount == 0)
 	{
-		if (!particle.m_IsActive)
-		{
-			continue;
-		}
+		return;
+	}
+	m_InstanceBuffer.setData(m_InstanceData.data(), (unsigned int)m_AliveCount);
 
-		float life = particle.m_LifeRemaining / particle.m_LifeTime;
-		float size = particle.m_SizeBegin * (life) + particle.m_SizeEnd * (1.0f - life);
-		
-		RenderSystem::GetSingleton()->pushMatrixOverride(Matrix::CreateScale(size) * particle.m_Transform);
-		
-		m_BasicMaterial->setColor(Color::Lerp(particle.m_ColorEnd, particle.m_ColorBegin, life));
-		RenderSystem::GetSingleton()->getRenderer()->bind(m_BasicMaterial.get());
-		
-		for (auto& [material, meshes] : m_ModelResourceFile->getMeshes())
+	m_BasicMaterial->bindInstancedMaterial();
+	m_InstanceBuffer.bind();
+	for (auto& [material, meshes] : m_ModelResourceFile->getMeshes())
+	{
+		for (auto& mesh : meshes)
 		{
-			for (auto& mesh : meshes)
-			{
-				RenderSystem::GetSingleton()->getRenderer()->draw(mesh.m_VertexBuffer.get(), mesh.m_IndexBuffer.get());
-			}
+			mesh.m_VertexBuffer->bind();
+			mesh.m_IndexBuffer->bind();
+			RenderingDevice::GetSingleton()->drawIndexedInstanced(mesh.m_IndexBuffer->getCount(), (unsigned int)m_AliveCount, 0);
 		}
-		RenderSystem::GetSingleton()->popMatrix();
 	}
 }
 
-void CPUParticlesComponent::postRender()
+float CPUParticlesComponent::random()
 {
-	ModelComponent::postRender();
-	m_LastRenderTimePoint = std::chrono::high_resolution_clock::now();
+	m_RandomState ^= m_RandomState << 13;
+	m_RandomState ^= m_RandomState >> 17;
+	m_RandomState ^= m_RandomState << 5;
+	// Top 24 bits, which a float holds exactly
+	return (m_RandomState >> 8) * (1.0f / 16777216.0f);
 }
 
 void CPUParticlesComponent::emit(const ParticleTemplate& particleTemplate)
 {
-	Particle& particle = m_ParticlePool[m_PoolIndex];
-
-	particle.m_IsActive = true;
+	if (m_AliveCount == m_PoolSize)
+	{
+		return;
+	}
+	const size_t i = m_AliveCount++;
 
-	static Matrix initialTransform;
-	initialTransform = Matrix::Identity;
+	Vector3 offset;
 	switch (m_CurrentEmitMode)
 	{
 	case CPUParticlesComponent::EmitMode::Point:
 		break;
 	case CPUParticlesComponent::EmitMode::Square:
-		initialTransform = Matrix::CreateTranslation({ Random::Float() * m_EmitterDimensions.x, 0, Random::Float() * m_EmitterDimensions.z });
+		offset = { random() * m_EmitterDimensions.x, 0, random() * m_EmitterDimensions.z };
 		break;
 	case CPUParticlesComponent::EmitMode::Cube:
-		initialTransform = Matrix::CreateTranslation({ Random::Float() * m_EmitterDimensions.x, Random::Float() * m_EmitterDimensions.y, Random::Float() * m_EmitterDimensions.z });
+		offset = { random() * m_EmitterDimensions.x, random() * m_EmitterDimensions.y, random() * m_EmitterDimensions.z };
 		break;
 	default:
 		break;
 	}
 
-	particle.m_Transform = initialTransform * m_TransformComponent->getAbsoluteTransform();
-
-	particle.m_Velocity = particleTemplate.m_Velocity;
-	particle.m_Velocity.x += particleTemplate.m_VelocityVariation * (Random::Float() - 0.5f);
-	particle.m_Velocity.y += particleTemplate.m_VelocityVariation * (Random::Float() - 0.5f);
-	particle.m_Velocity.z += particleTemplate.m_VelocityVariation * (Random::Float() - 0.5f);
-
-	particle.m_AngularVelocity = Vector3(Random::Float() - 0.5f, Random::Float() - 0.5f, Random::Float() - 0.5f) * particleTemplate.m_AngularVelocityVariation;
-	particle.m_AngularVelocity.Normalize();
-
-	particle.m_ColorBegin = particleTemplate.m_ColorBegin;
-	particle.m_ColorEnd = particleTemplate.m_ColorEnd;
-
-	particle.m_LifeTime = particleTemplate.m_LifeTime;
-	particle.m_LifeRemaining = particleTemplate.m_LifeTime;
-	particle.m_SizeBegin = particleTemplate.m_SizeBegin + particleTemplate.m_SizeVariation * (Random::Float() - 0.5f);
-	particle.m_SizeEnd = particleTemplate.m_SizeEnd;
-
-	m_PoolIndex = --m_PoolIndex % m_ParticlePool.size();
+	const Matrix& emitterTransform = m_TransformComponent->getAbsoluteTransform();
+	const Vector3 position = Vector3::Transform(offset, emitterTransform);
+	m_PositionX[i] = position.x;
+	m_PositionY[i] = position.y;
+	m_PositionZ[i] = position.z;
+
+	Vector3 velocity = particleTemplate.m_Velocity;
+	velocity.x += particleTemplate.m_VelocityVariation * (random() - 0.5f);
+	velocity.y += particleTemplate.m_VelocityVariation * (random() - 0.5f);
+	velocity.z += particleTemplate.m_VelocityVariation * (random() - 0.5f);
+	velocity = Vector3::TransformNormal(velocity, emitterTransform);
+	m_VelocityX[i] = velocity.x;
+	m_VelocityY[i] = velocity.y;
+	m_VelocityZ[i] = velocity.z;
+
+	Vector3 angularVelocity = Vector3(random() - 0.5f, random() - 0.5f, random() - 0.5f) * particleTemplate.m_AngularVelocityVariation;
+	angularVelocity.Normalize();
+	m_RotationX[i] = 0.0f;
+	m_RotationY[i] = 0.0f;
+	m_RotationZ[i] = 0.0f;
+	m_AngularVelocityX[i] = angularVelocity.x;
+	m_AngularVelocityY[i] = angularVelocity.y;
+	m_AngularVelocityZ[i] = angularVelocity.z;
+
+	m_ColorBegin[i] = particleTemplate.m_ColorBegin;
+	m_ColorEnd[i] = particleTemplate.m_ColorEnd;
+
+	m_LifeRemaining[i] = particleTemplate.m_LifeTime;
+	m_InverseLifeTime[i] = 1.0f / particleTemplate.m_LifeTime;
+	m_SizeBegin[i] = particleTemplate.m_SizeBegin + particleTemplate.m_SizeVariation * (random() - 0.5f);
+	m_SizeEnd[i] = particleTemplate.m_SizeEnd;
 }
 
 void CPUParticlesComponent::expandPool(const size_t& poolSize)
@@ -205,8 +302,20 @@ void CPUParticlesComponent::expandPool(const size_t& poolSize)
 		return;
 	}
 
-	m_ParticlePool.resize(poolSize);
-	m_PoolIndex = poolSize - 1;
+	const size_t paddedSize = (poolSize + 3) & ~(size_t)3;
+	for (Vector<float>* stream : { &m_PositionX, &m_PositionY, &m_PositionZ, &m_VelocityX, &m_VelocityY, &m_VelocityZ, &m_RotationX, &m_RotationY, &m_RotationZ, &m_AngularVelocityX, &m_AngularVelocityY, &m_AngularVelocityZ, &m_LifeRemaining, &m_InverseLifeTime, &m_SizeBegin, &m_SizeEnd })
+	{
+		stream->resize(paddedSize, 0.0f);
+	}
+	m_ColorBegin.resize(paddedSize);
+	m_ColorEnd.resize(paddedSize);
+	m_InstanceData.resize(paddedSize);
+
+	m_PoolSize = poolSize;
+	if (m_AliveCount > m_PoolSize)
+	{
+		m_AliveCount = m_PoolSize;
+	}
 }
 
 JSON::json CPUParticlesComponent::getJSON() const
@@ -215,7 +324,7 @@ JSON::json CPUParticlesComponent::getJSON() const
 
 	j["materialPath"] = m_BasicMaterial->getFileName();
 
-	j["poolSize"] = m_ParticlePool.size();
+	j["poolSize"] = m_PoolSize;
 	j["velocity"]["x"] = m_ParticleTemplate.m_Velocity.x;
 	j["velocity"]["y"] = m_ParticleTemplate.m_Velocity.y;
 	j["velocity"]["z"] = m_ParticleTemplate.m_Velocity.z;
@@ -263,11 +372,12 @@ void CPUParticlesComponent::draw()
 	};
 	ImGui::Combo("Emit Mode", (int*)&m_CurrentEmitMode, emitModes, 3);
 	ImGui::DragFloat3("Emitter Dimensions", &m_EmitterDimensions.x);
-	int poolSize = m_ParticlePool.size();
+	int poolSize = m_PoolSize;
 	if (ImGui::DragInt("Pool Size", &poolSize, 1.0f, 1, 100000)) 
 	{
 		expandPool(poolSize);
 	}
+	ImGui::Text("Alive: %d", (int)m_AliveCount);
 	ImGui::DragInt("Emit Rate", &m_EmitRate);
 	
 	ImGui::Separator();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "model_component.h"
+#include "renderer/instance_buffer.h"
 
 struct ParticleTemplate
 {
@@ -17,30 +18,43 @@ struct ParticleTemplate
 
 class CPUParticlesComponent : public ModelComponent
 {
+	DEFINE_COMPONENT_POOL(CPUParticlesComponent);
+
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 	
-	struct Particle
-	{
-		bool m_IsActive = false;
-		float m_SizeBegin;
-		float m_SizeEnd;
-		float m_LifeTime;
-		float m_LifeRemaining;
-		Color m_ColorBegin;
-		Color m_ColorEnd;
-		Vector3 m_Velocity;
-		Vector3 m_AngularVelocity;
-		Matrix m_Transform;
-	};
-
 	ParticleTemplate m_ParticleTemplate;
-	Vector<Particle> m_ParticlePool;
+
+	/// Particles in structure of arrays form, with the live ones packed in front up to m_AliveCount.
+	/// Streams are padded to a multiple of 4 particles, so that they can be updated 4 at a time.
+	Vector<float> m_PositionX;
+	Vector<float> m_PositionY;
+	Vector<float> m_PositionZ;
+	Vector<float> m_VelocityX;
+	Vector<float> m_VelocityY;
+	Vector<float> m_VelocityZ;
+	/// Yaw, pitch and roll.
+	Vector<float> m_RotationX;
+	Vector<float> m_RotationY;
+	Vector<float> m_RotationZ;
+	Vector<float> m_AngularVelocityX;
+	Vector<float> m_AngularVelocityY;
+	Vector<float> m_AngularVelocityZ;
+	Vector<float> m_LifeRemaining;
+	Vector<float> m_InverseLifeTime;
+	Vector<float> m_SizeBegin;
+	Vector<float> m_SizeEnd;
+	Vector<Color> m_ColorBegin;
+	Vector<Color> m_ColorEnd;
+	size_t m_PoolSize;
+	size_t m_AliveCount;
+
 	Ref<BasicMaterial> m_BasicMaterial;
-	size_t m_PoolIndex;
+	/// Transform and color of every particle, written by simulate() and drawn with one instanced draw per mesh.
+	Vector<InstanceData> m_InstanceData;
+	InstanceBuffer m_InstanceBuffer;
 	int m_EmitRate;
 	TransformComponent* m_TransformComponent;
-	std::chrono::time_point<std::chrono::high_resolution_clock> m_LastRenderTimePoint;
 	
 	enum class EmitMode : int
 	{
@@ -51,9 +65,16 @@ class CPUParticlesComponent : public ModelComponent
 
 	EmitMode m_CurrentEmitMode;
 	Vector3 m_EmitterDimensions;
+	/// State of the xorshift sequence emission draws from, seeded by the entity ID so that each emitter is deterministic on its own.
+	unsigned int m_RandomState;
 
 	friend class EntityFactory;
 
+	/// Removes the live particle at index by moving the last live particle over it.
+	void kill(size_t index);
+	/// Next number of the emitter's random sequence, between 0.0f and 1.0f.
+	float random();
+
 public:
 	static const ComponentID s_ID = (ComponentID)ComponentIDs::CPUParticlesComponent;
 
@@ -62,12 +83,24 @@ public:
 	virtual ~CPUParticlesComponent() = default;
 
 	virtual bool setup() override;
-	virtual bool preRender() override;
+	virtual void submit(RenderQueue& queue) override;
 	virtual void render() override;
-	virtual void postRender() override;
+	/// Particles leave the emitter bounds as soon as they are emitted.
+	virtual bool isCullable() const override { return false; }
 
+	/// Emits the particles of this frame.
+	void emitParticles();
+	/// Moves and ages the particles from begin up to end by deltaSeconds, and writes their instance data. begin must be a multiple of 4 and end at most getSimulatedCount().
+	/// Disjoint ranges can be simulated on different threads.
+	void simulate(size_t begin, size_t end, float deltaSeconds);
+	/// Removes the particles whose life has run out.
+	void removeDead();
+	/// Adds a particle unless all particles of the pool are alive.
 	void emit(const ParticleTemplate& particleTemplate);
 	void expandPool(const size_t& poolSize);
+	size_t getAliveCount() const { return m_AliveCount; }
+	/// Live particles rounded up to a multiple of 4.
+	size_t getSimulatedCount() const { return (m_AliveCount + 3) & ~(size_t)3; }
 
 	virtual String getName() const override { return "CPUParticlesComponent"; }
 	ComponentID getComponentID() const override { return s_ID; }
@@ -4,6 +4,8 @@
 /// Component to apply directional light to the scene, only the first created instance is used in case of multiple such components
 class DirectionalLightComponent : public Component
 {
+	DEFINE_COMPONENT_POOL(DirectionalLightComponent);
+
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
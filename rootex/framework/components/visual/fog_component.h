@@ -4,6 +4,8 @@
 
 class FogComponent : public Component
 {
+	DEFINE_COMPONENT_POOL(FogComponent);
+
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
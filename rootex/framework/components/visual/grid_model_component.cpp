@@ -1,6 +1,7 @@
 #include "grid_model_component.h"
 
 #include "framework/systems/render_system.h"
+#include "framework/render_queue.h"
 
 Component* GridModelComponent::Create(const JSON::json& componentData)
 {
@@ -33,7 +34,7 @@ GridModelComponent::GridModelComponent(const Vector2& cellSize, const int& cellC
 
 void GridModelComponent::refreshVertexBuffers()
 {
-	const Vector3& origin = m_TransformComponent->getAbsoluteTransform().Translation();
+	const Vector3& origin = m_TransformComponent->getAbsolutePosition();
 
 	Vector<float> vertices;
 	Vector<unsigned short> indices;
@@ -116,6 +117,11 @@ bool GridModelComponent::setup()
 	return status;
 }
 
+void GridModelComponent::submit(RenderQueue& queue)
+{
+	queue.submitCustom(this, m_ColorMaterial.get(), m_TransformComponent->getAbsolutePosition());
+}
+
 void GridModelComponent::render()
 {
 	RenderSystem::GetSingleton()->enableLineRenderMode();
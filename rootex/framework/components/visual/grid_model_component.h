@@ -6,6 +6,8 @@
 
 class GridModelComponent : public ModelComponent
 {
+	DEFINE_COMPONENT_POOL(GridModelComponent);
+
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
@@ -28,7 +30,10 @@ public:
 	static const ComponentID s_ID = (ComponentID)ComponentIDs::GridModelComponent;
 
 	virtual bool setup() override;
+	void submit(RenderQueue& queue) override;
 	void render() override;
+	/// The grid is drawn far outside its transform bounds.
+	bool isCullable() const override { return false; }
 
 	virtual String getName() const override { return "GridModelComponent"; }
 	ComponentID getComponentID() const override { return s_ID; }
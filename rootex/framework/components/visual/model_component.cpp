@@ -5,6 +5,7 @@
 #include "core/resource_loader.h"
 #include "event_manager.h"
 #include "framework/entity.h"
+#include "framework/render_queue.h"
 #include "framework/systems/light_system.h"
 #include "framework/systems/render_system.h"
 #include "renderer/material_library.h"
@@ -12,10 +13,17 @@
 
 Component* ModelComponent::Create(const JSON::json& componentData)
 {
+	bool isOccluder = false;
+	if (componentData.contains("isOccluder"))
+	{
+		isOccluder = componentData["isOccluder"];
+	}
+
 	ModelComponent* modelComponent = new ModelComponent(
 	    componentData["renderPass"],
 	    ResourceLoader::CreateModelResourceFile(componentData["resFile"]),
-	    componentData["isVisible"]);
+	    componentData["isVisible"],
+	    isOccluder);
 
 	return modelComponent;
 }
@@ -30,13 +38,18 @@ Component* ModelComponent::CreateDefault()
 	return modelComponent;
 }
 
-ModelComponent::ModelComponent(unsigned int renderPass, ModelResourceFile* resFile, bool visibility)
+ModelComponent::ModelComponent(unsigned int renderPass, ModelResourceFile* resFile, bool visibility, bool isOccluder)
     : m_IsVisible(visibility)
+    , m_IsOccluder(isOccluder)
     , m_RenderPass(renderPass)
     , m_ModelResourceFile(resFile)
     , m_TransformComponent(nullptr)
     , m_HierarchyComponent(nullptr)
 {
+	if (m_IsOccluder && m_ModelResourceFile)
+	{
+		ResourceLoader::LoadOccluderGeometry(m_ModelResourceFile);
+	}
 }
 
 void ModelComponent::RegisterAPI(sol::table& rootex)
@@ -47,6 +60,9 @@ void ModelComponent::RegisterAPI(sol::table& rootex)
 	rootex["Entity"]["getModel"] = &Entity::getComponent<ModelComponent>;
 	modelComponent["isVisible"] = &ModelComponent::isVisible;
 	modelComponent["setIsVisible"] = &ModelComponent::setIsVisible;
+	modelComponent["isCulled"] = &ModelComponent::isCulled;
+	modelComponent["isOccluder"] = &ModelComponent::isOccluder;
+	modelComponent["setIsOccluder"] = &ModelComponent::setIsOccluder;
 }
 
 bool ModelComponent::setup()
@@ -54,14 +70,18 @@ bool ModelComponent::setup()
 	bool status = true;
 	if (m_Owner)
 	{
-		m_TransformComponent = m_Owner->getComponent<TransformComponent>().get();
+		m_TransformComponent = m_Owner->getComponentPtr<TransformComponent>();
 		if (m_TransformComponent == nullptr)
 		{
 			WARN("Entity without transform component found");
 			status = false;
 		}
+		else
+		{
+			updateBounds();
+		}
 
-		m_HierarchyComponent = m_Owner->getComponent<HierarchyComponent>().get();
+		m_HierarchyComponent = m_Owner->getComponentPtr<HierarchyComponent>();
 		if (m_HierarchyComponent == nullptr)
 		{
 			WARN("Entity without hierarchy component found");
@@ -72,6 +92,14 @@ bool ModelComponent::setup()
 	return status;
 }
 
+void ModelComponent::submit(RenderQueue& queue)
+{
+	if (m_ModelResourceFile && m_TransformComponent)
+	{
+		queue.submit(this, m_TransformComponent->getAbsoluteTransform());
+	}
+}
+
 bool ModelComponent::preRender()
 {
 	if (m_TransformComponent)
@@ -87,19 +115,11 @@ bool ModelComponent::preRender()
 
 bool ModelComponent::isVisible() const
 {
-	// TODO: Add culling
 	return m_IsVisible;
 }
 
-bool compareMaterials(const Pair<Ref<Material>, Vector<Mesh>>& a, const Pair<Ref<Material>, Vector<Mesh>>& b)
-{
-	// Alpha materials final last
-	return !a.first->isAlpha() && b.first->isAlpha();
-}
-
 void ModelComponent::render()
 {
-	std::sort(m_ModelResourceFile->getMeshes().begin(), m_ModelResourceFile->getMeshes().end(), compareMaterials);
 	for (auto& [material, meshes] : m_ModelResourceFile->getMeshes())
 	{
 		RenderSystem::GetSingleton()->getRenderer()->bind(material.get());
@@ -119,6 +139,19 @@ void ModelComponent::postRender()
 void ModelComponent::setVisualModel(ModelResourceFile* newModel)
 {
 	m_ModelResourceFile = newModel;
+	if (m_IsOccluder && m_ModelResourceFile)
+	{
+		ResourceLoader::LoadOccluderGeometry(m_ModelResourceFile);
+	}
+	updateBounds();
+}
+
+void ModelComponent::updateBounds()
+{
+	if (m_TransformComponent && m_ModelResourceFile)
+	{
+		m_TransformComponent->setBounds(m_ModelResourceFile->getBounds());
+	}
 }
 
 void ModelComponent::setIsVisible(bool enabled)
@@ -126,6 +159,16 @@ void ModelComponent::setIsVisible(bool enabled)
 	m_IsVisible = enabled;
 }
 
+void ModelComponent::setIsOccluder(bool enabled)
+{
+	m_IsOccluder = enabled;
+	if (m_IsOccluder && m_ModelResourceFile)
+	{
+		ResourceLoader::LoadOccluderGeometry(m_ModelResourceFile);
+	}
+	markChanged();
+}
+
 JSON::json ModelComponent::getJSON() const
 {
 	JSON::json j;
@@ -133,6 +176,7 @@ JSON::json ModelComponent::getJSON() const
 	j["resFile"] = m_ModelResourceFile->getPath().string();
 	j["isVisible"] = m_IsVisible;
 	j["renderPass"] = m_RenderPass;
+	j["isOccluder"] = m_IsOccluder;
 
 	return j;
 }
@@ -143,6 +187,11 @@ JSON::json ModelComponent::getJSON() const
 void ModelComponent::draw()
 {
 	ImGui::Checkbox("Visible", &m_IsVisible);
+	bool isOccluder = m_IsOccluder;
+	if (ImGui::Checkbox("Occluder", &isOccluder))
+	{
+		setIsOccluder(isOccluder);
+	}
 
 	ImGui::BeginGroup();
 
@@ -6,22 +6,39 @@
 #include "renderer/material.h"
 #include "core/resource_file.h"
 
+class RenderQueue;
+
 class ModelComponent : public Component
 {
+	DEFINE_COMPONENT_POOL(ModelComponent);
+
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
 	friend class EntityFactory;
+	friend class VisibilitySystem;
 
 protected:
 	ModelResourceFile* m_ModelResourceFile;
 	bool m_IsVisible;
+	/// Set by the VisibilitySystem when the bounds are outside the camera frustum or hidden behind occluders this frame.
+	bool m_IsCulled = false;
+	/// Visibility results kept by the VisibilitySystem across frames, m_IsCulled being either of them.
+	bool m_IsOutsideFrustum = false;
+	bool m_IsOccluded = false;
+	/// Frame of the last VisibilitySystem hierarchy walk that reached this model.
+	unsigned int m_VisibilityFrame = (unsigned int)-1;
+	/// Rasterized into the occlusion buffer to hide models behind it. Meant for large, closed meshes like walls and terrain.
+	bool m_IsOccluder;
 	int m_RenderPass;
 
 	HierarchyComponent* m_HierarchyComponent;
 	TransformComponent* m_TransformComponent;
 
-	ModelComponent(unsigned int renderPass, ModelResourceFile* resFile, bool isVisible);
+	/// Fits the transform bounds to the model.
+	void updateBounds();
+
+	ModelComponent(unsigned int renderPass, ModelResourceFile* resFile, bool isVisible, bool isOccluder = false);
 	ModelComponent(ModelComponent&) = delete;
 	virtual ~ModelComponent() = default;
 
@@ -35,13 +52,22 @@ public:
 
 	virtual bool setup() override;
 
+	/// Queues the draws of this model for the frame.
+	virtual void submit(RenderQueue& queue);
+	/// Called around render() for models drawing themselves from the render queue.
 	virtual bool preRender();
 	virtual bool isVisible() const;
+	bool isCulled() const { return m_IsCulled; }
+	/// Models drawing outside their transform bounds should return false to never be culled.
+	virtual bool isCullable() const { return true; }
+	/// Draws the model immediately, outside the render queue.
 	virtual void render();
 	virtual void postRender();
 
 	void setVisualModel(ModelResourceFile* newModel);
 	void setIsVisible(bool enabled);
+	void setIsOccluder(bool enabled);
+	bool isOccluder() const { return m_IsOccluder; }
 	
 	unsigned int getRenderPass() const { return m_RenderPass; }
 	const Vector<Pair<Ref<Material>, Vector<Mesh>>>& getMeshes() const { return m_ModelResourceFile->getMeshes(); }
@@ -4,6 +4,8 @@
 /// Component to apply point lights to the scene, first 4 created instances of this are used
 class PointLightComponent : public Component
 {
+	DEFINE_COMPONENT_POOL(PointLightComponent);
+
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
@@ -18,7 +18,7 @@ void RenderUIComponent::RegisterAPI(sol::table& rootex)
 
 bool RenderUIComponent::setup()
 {
-	m_TransformComponent = m_Owner->getComponent<TransformComponent>().get();
+	m_TransformComponent = m_Owner->getComponentPtr<TransformComponent>();
 	if (!m_TransformComponent)
 	{
 		ERR("TransformComponent not found on RenderUIComponent");
@@ -6,6 +6,8 @@
 
 class SkyComponent : public Component
 {
+	DEFINE_COMPONENT_POOL(SkyComponent);
+
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
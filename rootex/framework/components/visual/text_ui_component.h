@@ -6,6 +6,8 @@
 /// Component to render 2D UI Text
 class TextUIComponent : public RenderUIComponent
 {
+	DEFINE_COMPONENT_POOL(TextUIComponent);
+
 public:
 	/// DirectXTK flipping modes for sprites
 	enum class Mode
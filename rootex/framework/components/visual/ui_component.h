@@ -8,6 +8,8 @@
 
 class UIComponent : public Component
 {
+	DEFINE_COMPONENT_POOL(UIComponent);
+
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
@@ -0,0 +1,514 @@
+#include "dynamic_aabb_tree.h"
+
+static int MaxHeight(int a, int b)
+{
+	return a > b ? a : b;
+}
+
+bool AABB::intersects(const Vector3& origin, const Vector3& inverseDirection, float maxDistance, float& distance) const
+{
+	Vector3 t1 = (m_Min - origin) * inverseDirection;
+	Vector3 t2 = (m_Max - origin) * inverseDirection;
+	Vector3 tNear = Vector3::Min(t1, t2);
+	Vector3 tFar = Vector3::Max(t1, t2);
+
+	float entry = tNear.x > tNear.y ? tNear.x : tNear.y;
+	entry = entry > tNear.z ? entry : tNear.z;
+	float exit = tFar.x < tFar.y ? tFar.x : tFar.y;
+	exit = exit < tFar.z ? exit : tFar.z;
+
+	if (exit < 0.0f || entry > exit || entry > maxDistance)
+	{
+		return false;
+	}
+	distance = entry < 0.0f ? 0.0f : entry;
+	return true;
+}
+
+Frustum Frustum::FromViewProjection(const Matrix& viewProjection)
+{
+	const Matrix& m = viewProjection;
+	Vector4 column1(m._11, m._21, m._31, m._41);
+	Vector4 column2(m._12, m._22, m._32, m._42);
+	Vector4 column3(m._13, m._23, m._33, m._43);
+	Vector4 column4(m._14, m._24, m._34, m._44);
+
+	// Clip space planes facing inwards, with depth from 0 to 1
+	Frustum frustum;
+	frustum.m_Planes[0] = column4 + column1;
+	frustum.m_Planes[1] = column4 - column1;
+	frustum.m_Planes[2] = column4 + column2;
+	frustum.m_Planes[3] = column4 - column2;
+	frustum.m_Planes[4] = column3;
+	frustum.m_Planes[5] = column4 - column3;
+
+	for (Vector4& plane : frustum.m_Planes)
+	{
+		float length = Vector3(plane.x, plane.y, plane.z).Length();
+		plane = -plane / length;
+	}
+	return frustum;
+}
+
+void Frustum::GetCorners(const Matrix& viewProjection, Vector3 (&corners)[8])
+{
+	const Matrix inverse = viewProjection.Invert();
+	for (int i = 0; i < 8; i++)
+	{
+		const Vector3 clip((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : 0.0f);
+		corners[i] = Vector3::Transform(clip, inverse);
+	}
+}
+
+Frustum Frustum::inflated(float margin) const
+{
+	Frustum frustum = *this;
+	for (Vector4& plane : frustum.m_Planes)
+	{
+		plane.w -= margin;
+	}
+	return frustum;
+}
+
+bool Frustum::isInside(const Vector3& point) const
+{
+	for (const Vector4& plane : m_Planes)
+	{
+		if (plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w > 0.0f)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Frustum::intersects(const AABB& box) const
+{
+	Vector3 center = (box.m_Min + box.m_Max) * 0.5f;
+	Vector3 extents = (box.m_Max - box.m_Min) * 0.5f;
+	for (const Vector4& plane : m_Planes)
+	{
+		float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+		float radius = extents.x * fabsf(plane.x) + extents.y * fabsf(plane.y) + extents.z * fabsf(plane.z);
+		if (distance > radius)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+DirectX::ContainmentType Frustum::contains(const AABB& box) const
+{
+	Vector3 center = (box.m_Min + box.m_Max) * 0.5f;
+	Vector3 extents = (box.m_Max - box.m_Min) * 0.5f;
+	bool isInside = true;
+	for (const Vector4& plane : m_Planes)
+	{
+		float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+		float radius = extents.x * fabsf(plane.x) + extents.y * fabsf(plane.y) + extents.z * fabsf(plane.z);
+		if (distance > radius)
+		{
+			return DirectX::DISJOINT;
+		}
+		if (distance > -radius)
+		{
+			isInside = false;
+		}
+	}
+	return isInside ? DirectX::CONTAINS : DirectX::INTERSECTS;
+}
+
+DynamicAABBTree::DynamicAABBTree()
+    : m_Root(-1)
+    , m_FreeList(-1)
+    , m_LeafCount(0)
+{
+}
+
+int DynamicAABBTree::allocateNode()
+{
+	int node = m_FreeList;
+	if (node < 0)
+	{
+		node = (int)m_Nodes.size();
+		m_Nodes.emplace_back();
+	}
+	else
+	{
+		m_FreeList = m_Nodes[node].m_Parent;
+	}
+
+	Node& allocated = m_Nodes[node];
+	allocated.m_Entity = nullptr;
+	allocated.m_Parent = -1;
+	allocated.m_Child1 = -1;
+	allocated.m_Child2 = -1;
+	allocated.m_Height = 0;
+	return node;
+}
+
+void DynamicAABBTree::freeNode(int node)
+{
+	m_Nodes[node].m_Parent = m_FreeList;
+	m_Nodes[node].m_Height = -1;
+	m_FreeList = node;
+}
+
+void DynamicAABBTree::insertLeaf(int leaf)
+{
+	if (m_Root < 0)
+	{
+		m_Root = leaf;
+		m_Nodes[leaf].m_Parent = -1;
+		return;
+	}
+
+	// Descend towards the sibling that grows the total surface area the least
+	const AABB leafBox = m_Nodes[leaf].m_Box;
+	int index = m_Root;
+	while (!m_Nodes[index].isLeaf())
+	{
+		const Node& node = m_Nodes[index];
+		float area = node.m_Box.getPerimeter();
+		float combinedArea = AABB::Union(node.m_Box, leafBox).getPerimeter();
+
+		// Cost of pairing the leaf with this node, and the minimum cost pushed down to either child
+		float cost = 2.0f * combinedArea;
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float childCosts[2];
+		int children[2] = { node.m_Child1, node.m_Child2 };
+		for (int i = 0; i < 2; i++)
+		{
+			const Node& child = m_Nodes[children[i]];
+			float newArea = AABB::Union(leafBox, child.m_Box).getPerimeter();
+			childCosts[i] = (child.isLeaf() ? newArea : newArea - child.m_Box.getPerimeter()) + inheritanceCost;
+		}
+
+		if (cost < childCosts[0] && cost < childCosts[1])
+		{
+			break;
+		}
+		index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+	}
+
+	int sibling = index;
+	int oldParent = m_Nodes[sibling].m_Parent;
+	int newParent = allocateNode();
+	m_Nodes[newParent].m_Parent = oldParent;
+	m_Nodes[newParent].m_Box = AABB::Union(leafBox, m_Nodes[sibling].m_Box);
+	m_Nodes[newParent].m_Height = m_Nodes[sibling].m_Height + 1;
+	m_Nodes[newParent].m_Child1 = sibling;
+	m_Nodes[newParent].m_Child2 = leaf;
+	m_Nodes[sibling].m_Parent = newParent;
+	m_Nodes[leaf].m_Parent = newParent;
+
+	if (oldParent < 0)
+	{
+		m_Root = newParent;
+	}
+	else if (m_Nodes[oldParent].m_Child1 == sibling)
+	{
+		m_Nodes[oldParent].m_Child1 = newParent;
+	}
+	else
+	{
+		m_Nodes[oldParent].m_Child2 = newParent;
+	}
+
+	// Refit and rebalance the ancestors
+	index = m_Nodes[leaf].m_Parent;
+	while (index >= 0)
+	{
+		index = balance(index);
+
+		Node& node = m_Nodes[index];
+		node.m_Height = 1 + MaxHeight(m_Nodes[node.m_Child1].m_Height, m_Nodes[node.m_Child2].m_Height);
+		node.m_Box = AABB::Union(m_Nodes[node.m_Child1].m_Box, m_Nodes[node.m_Child2].m_Box);
+
+		index = node.m_Parent;
+	}
+}
+
+void DynamicAABBTree::removeLeaf(int leaf)
+{
+	if (leaf == m_Root)
+	{
+		m_Root = -1;
+		return;
+	}
+
+	int parent = m_Nodes[leaf].m_Parent;
+	int grandParent = m_Nodes[parent].m_Parent;
+	int sibling = m_Nodes[parent].m_Child1 == leaf ? m_Nodes[parent].m_Child2 : m_Nodes[parent].m_Child1;
+
+	freeNode(parent);
+	if (grandParent < 0)
+	{
+		m_Root = sibling;
+		m_Nodes[sibling].m_Parent = -1;
+		return;
+	}
+
+	// Put the sibling in place of the parent
+	if (m_Nodes[grandParent].m_Child1 == parent)
+	{
+		m_Nodes[grandParent].m_Child1 = sibling;
+	}
+	else
+	{
+		m_Nodes[grandParent].m_Child2 = sibling;
+	}
+	m_Nodes[sibling].m_Parent = grandParent;
+
+	int index = grandParent;
+	while (index >= 0)
+	{
+		index = balance(index);
+
+		Node& node = m_Nodes[index];
+		node.m_Height = 1 + MaxHeight(m_Nodes[node.m_Child1].m_Height, m_Nodes[node.m_Child2].m_Height);
+		node.m_Box = AABB::Union(m_Nodes[node.m_Child1].m_Box, m_Nodes[node.m_Child2].m_Box);
+
+		index = node.m_Parent;
+	}
+}
+
+int DynamicAABBTree::balance(int iA)
+{
+	Node& a = m_Nodes[iA];
+	if (a.isLeaf() || a.m_Height < 2)
+	{
+		return iA;
+	}
+
+	int iB = a.m_Child1;
+	int iC = a.m_Child2;
+	Node& b = m_Nodes[iB];
+	Node& c = m_Nodes[iC];
+
+	int heightDifference = c.m_Height - b.m_Height;
+
+	// Rotate C up
+	if (heightDifference > 1)
+	{
+		int iF = c.m_Child1;
+		int iG = c.m_Child2;
+		Node& f = m_Nodes[iF];
+		Node& g = m_Nodes[iG];
+
+		c.m_Child1 = iA;
+		c.m_Parent = a.m_Parent;
+		a.m_Parent = iC;
+
+		if (c.m_Parent < 0)
+		{
+			m_Root = iC;
+		}
+		else if (m_Nodes[c.m_Parent].m_Child1 == iA)
+		{
+			m_Nodes[c.m_Parent].m_Child1 = iC;
+		}
+		else
+		{
+			m_Nodes[c.m_Parent].m_Child2 = iC;
+		}
+
+		if (f.m_Height > g.m_Height)
+		{
+			c.m_Child2 = iF;
+			a.m_Child2 = iG;
+			g.m_Parent = iA;
+			a.m_Box = AABB::Union(b.m_Box, g.m_Box);
+			c.m_Box = AABB::Union(a.m_Box, f.m_Box);
+			a.m_Height = 1 + MaxHeight(b.m_Height, g.m_Height);
+			c.m_Height = 1 + MaxHeight(a.m_Height, f.m_Height);
+		}
+		else
+		{
+			c.m_Child2 = iG;
+			a.m_Child2 = iF;
+			f.m_Parent = iA;
+			a.m_Box = AABB::Union(b.m_Box, f.m_Box);
+			c.m_Box = AABB::Union(a.m_Box, g.m_Box);
+			a.m_Height = 1 + MaxHeight(b.m_Height, f.m_Height);
+			c.m_Height = 1 + MaxHeight(a.m_Height, g.m_Height);
+		}
+		return iC;
+	}
+
+	// Rotate B up
+	if (heightDifference < -1)
+	{
+		int iD = b.m_Child1;
+		int iE = b.m_Child2;
+		Node& d = m_Nodes[iD];
+		Node& e = m_Nodes[iE];
+
+		b.m_Child1 = iA;
+		b.m_Parent = a.m_Parent;
+		a.m_Parent = iB;
+
+		if (b.m_Parent < 0)
+		{
+			m_Root = iB;
+		}
+		else if (m_Nodes[b.m_Parent].m_Child1 == iA)
+		{
+			m_Nodes[b.m_Parent].m_Child1 = iB;
+		}
+		else
+		{
+			m_Nodes[b.m_Parent].m_Child2 = iB;
+		}
+
+		if (d.m_Height > e.m_Height)
+		{
+			b.m_Child2 = iD;
+			a.m_Child1 = iE;
+			e.m_Parent = iA;
+			a.m_Box = AABB::Union(c.m_Box, e.m_Box);
+			b.m_Box = AABB::Union(a.m_Box, d.m_Box);
+			a.m_Height = 1 + MaxHeight(c.m_Height, e.m_Height);
+			b.m_Height = 1 + MaxHeight(a.m_Height, d.m_Height);
+		}
+		else
+		{
+			b.m_Child2 = iE;
+			a.m_Child1 = iD;
+			d.m_Parent = iA;
+			a.m_Box = AABB::Union(c.m_Box, d.m_Box);
+			b.m_Box = AABB::Union(a.m_Box, e.m_Box);
+			a.m_Height = 1 + MaxHeight(c.m_Height, d.m_Height);
+			b.m_Height = 1 + MaxHeight(a.m_Height, e.m_Height);
+		}
+		return iB;
+	}
+
+	return iA;
+}
+
+int DynamicAABBTree::insert(const BoundingBox& box, Entity* entity)
+{
+	int proxy = allocateNode();
+	Node& leaf = m_Nodes[proxy];
+	leaf.m_TightBox = AABB::FromBoundingBox(box);
+	leaf.m_Box = { leaf.m_TightBox.m_Min - Vector3(DYNAMIC_AABB_TREE_MARGIN), leaf.m_TightBox.m_Max + Vector3(DYNAMIC_AABB_TREE_MARGIN) };
+	leaf.m_Entity = entity;
+
+	insertLeaf(proxy);
+	m_LeafCount++;
+	return proxy;
+}
+
+void DynamicAABBTree::remove(int proxy)
+{
+	removeLeaf(proxy);
+	freeNode(proxy);
+	m_LeafCount--;
+}
+
+bool DynamicAABBTree::move(int proxy, const BoundingBox& box)
+{
+	Node& leaf = m_Nodes[proxy];
+	leaf.m_TightBox = AABB::FromBoundingBox(box);
+
+	const Vector3 margin(DYNAMIC_AABB_TREE_MARGIN);
+	AABB grownBox = { leaf.m_TightBox.m_Min - margin, leaf.m_TightBox.m_Max + margin };
+	if (leaf.m_Box.contains(leaf.m_TightBox))
+	{
+		// Keep the old box unless the proxy shrank so much that it would slow down queries
+		AABB largestBox = { grownBox.m_Min - margin * 4.0f, grownBox.m_Max + margin * 4.0f };
+		if (largestBox.contains(leaf.m_Box))
+		{
+			return false;
+		}
+	}
+
+	removeLeaf(proxy);
+	m_Nodes[proxy].m_Box = grownBox;
+	insertLeaf(proxy);
+	return true;
+}
+
+void DynamicAABBTree::clear()
+{
+	m_Nodes.clear();
+	m_Root = -1;
+	m_FreeList = -1;
+	m_LeafCount = 0;
+}
+
+Entity* DynamicAABBTree::raycast(const Ray& ray, float maxDistance, const Function<bool(Entity*)>& filter, float& distance) const
+{
+	Entity* closest = nullptr;
+	if (m_Root < 0)
+	{
+		return closest;
+	}
+
+	const Vector3 inverseDirection(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+	float closestDistance = maxDistance;
+
+	m_Stack.clear();
+	m_Stack.push_back(m_Root);
+	while (!m_Stack.empty())
+	{
+		const Node& node = m_Nodes[m_Stack.back()];
+		m_Stack.pop_back();
+
+		// Subtrees starting behind the closest hit so far cannot contain a closer one
+		float nodeDistance = 0.0f;
+		if (!node.m_Box.intersects(ray.position, inverseDirection, closestDistance, nodeDistance))
+		{
+			continue;
+		}
+
+		if (node.isLeaf())
+		{
+			float hitDistance = 0.0f;
+			if (node.m_TightBox.intersects(ray.position, inverseDirection, closestDistance, hitDistance)
+			    && hitDistance > 0.0f && hitDistance < closestDistance && filter(node.m_Entity))
+			{
+				closestDistance = hitDistance;
+				closest = node.m_Entity;
+			}
+		}
+		else
+		{
+			m_Stack.push_back(node.m_Child1);
+			m_Stack.push_back(node.m_Child2);
+		}
+	}
+
+	if (closest)
+	{
+		distance = closestDistance;
+	}
+	return closest;
+}
+
+float DynamicAABBTree::getAreaRatio() const
+{
+	if (m_Root < 0)
+	{
+		return 0.0f;
+	}
+
+	float rootArea = m_Nodes[m_Root].m_Box.getPerimeter();
+	if (rootArea <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	float totalArea = 0.0f;
+	for (const Node& node : m_Nodes)
+	{
+		if (node.m_Height >= 0)
+		{
+			totalArea += node.m_Box.getPerimeter();
+		}
+	}
+	return totalArea / rootArea;
+}
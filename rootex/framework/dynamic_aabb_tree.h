@@ -0,0 +1,208 @@
+#pragma once
+
+#include "common/common.h"
+
+class Entity;
+
+/// Distance by which leaf boxes are grown on every side, so that small movements do not need a reinsertion.
+#define DYNAMIC_AABB_TREE_MARGIN 0.1f
+
+/// Axis aligned box stored as its corners, which makes unions and overlap tests cheaper than with BoundingBox.
+struct AABB
+{
+	Vector3 m_Min;
+	Vector3 m_Max;
+
+	static AABB FromBoundingBox(const BoundingBox& box) { return { box.Center - box.Extents, box.Center + box.Extents }; }
+	static AABB Union(const AABB& a, const AABB& b) { return { Vector3::Min(a.m_Min, b.m_Min), Vector3::Max(a.m_Max, b.m_Max) }; }
+
+	/// Half of the surface area, which is all the insertion cost heuristic needs.
+	float getPerimeter() const
+	{
+		Vector3 size = m_Max - m_Min;
+		return size.x * size.y + size.y * size.z + size.z * size.x;
+	}
+	bool contains(const AABB& other) const
+	{
+		return m_Min.x <= other.m_Min.x && m_Min.y <= other.m_Min.y && m_Min.z <= other.m_Min.z
+		    && other.m_Max.x <= m_Max.x && other.m_Max.y <= m_Max.y && other.m_Max.z <= m_Max.z;
+	}
+	bool intersects(const AABB& other) const
+	{
+		return m_Min.x <= other.m_Max.x && other.m_Min.x <= m_Max.x
+		    && m_Min.y <= other.m_Max.y && other.m_Min.y <= m_Max.y
+		    && m_Min.z <= other.m_Max.z && other.m_Min.z <= m_Max.z;
+	}
+	bool intersects(const Vector3& center, float radius) const
+	{
+		Vector3 closest = center;
+		closest.Clamp(m_Min, m_Max);
+		return Vector3::DistanceSquared(closest, center) <= radius * radius;
+	}
+	/// Slab test. distance is the entry distance along the ray, or 0 if origin is inside the box.
+	bool intersects(const Vector3& origin, const Vector3& inverseDirection, float maxDistance, float& distance) const;
+};
+
+/// View frustum as 6 planes pointing outwards, extracted from a view projection matrix.
+struct Frustum
+{
+	Vector4 m_Planes[6];
+
+	static Frustum FromViewProjection(const Matrix& viewProjection);
+	/// Corners of the frustum of viewProjection in world space.
+	static void GetCorners(const Matrix& viewProjection, Vector3 (&corners)[8]);
+
+	/// Same frustum with every plane moved outwards by margin.
+	Frustum inflated(float margin) const;
+	/// Returns true if the point is on the inner side of all planes.
+	bool isInside(const Vector3& point) const;
+
+	/// Returns false only if the box is entirely outside one of the planes. May report boxes near the frustum corners as visible.
+	bool intersects(const AABB& box) const;
+	/// Same test as intersects(), also telling apart boxes entirely inside all planes.
+	DirectX::ContainmentType contains(const AABB& box) const;
+};
+
+/// Bounding volume hierarchy over entity boxes that is updated incrementally.
+/// Leaves keep both the exact box and a box grown by DYNAMIC_AABB_TREE_MARGIN. Moving a leaf only touches the tree
+/// when its exact box leaves the grown one, and inserting picks the sibling with the least increase in surface area.
+/// Queries test the exact boxes, so results do not depend on the margin. Queries share a scratch stack, so they must not
+/// run concurrently or be started from inside a query callback.
+class DynamicAABBTree
+{
+	struct Node
+	{
+		/// Grown box for leaves, union of the children for internal nodes.
+		AABB m_Box;
+		/// Exact box. Only meaningful for leaves.
+		AABB m_TightBox;
+		Entity* m_Entity;
+		/// Next free node while the node is in the free list.
+		int m_Parent;
+		int m_Child1;
+		int m_Child2;
+		/// Leaves are at height 0, free nodes at -1.
+		int m_Height;
+
+		bool isLeaf() const { return m_Child1 < 0; }
+	};
+
+	Vector<Node> m_Nodes;
+	int m_Root;
+	int m_FreeList;
+	size_t m_LeafCount;
+	/// Scratch stack for traversals.
+	mutable Vector<int> m_Stack;
+
+	int allocateNode();
+	void freeNode(int node);
+
+	void insertLeaf(int leaf);
+	void removeLeaf(int leaf);
+	/// Performs a left or right rotation if node A is imbalanced. Returns the new root of the subtree.
+	int balance(int a);
+
+	/// Calls visit(const Node&) on every leaf whose grown box passes isOverlapping(const AABB&).
+	template <class Test, class Visit>
+	void traverse(Test&& isOverlapping, Visit&& visit) const;
+
+public:
+	DynamicAABBTree();
+	DynamicAABBTree(DynamicAABBTree&) = delete;
+	~DynamicAABBTree() = default;
+
+	/// Returns the proxy id identifying the new leaf.
+	int insert(const BoundingBox& box, Entity* entity);
+	void remove(int proxy);
+	/// Updates the box of a proxy. Returns true if the leaf had to be reinserted.
+	bool move(int proxy, const BoundingBox& box);
+	void clear();
+
+	/// Calls callback(Entity*) for every proxy overlapping the query.
+	template <class Callback>
+	void queryBox(const BoundingBox& box, Callback&& callback) const;
+	template <class Callback>
+	void querySphere(const Vector3& center, float radius, Callback&& callback) const;
+	template <class Callback>
+	void queryFrustum(const Frustum& frustum, Callback&& callback) const;
+	/// Returns the closest proxy hit in front of origin within maxDistance for which filter(Entity*) is true, nullptr if there is none.
+	Entity* raycast(const Ray& ray, float maxDistance, const Function<bool(Entity*)>& filter, float& distance) const;
+
+	Entity* getEntity(int proxy) const { return m_Nodes[proxy].m_Entity; }
+	size_t getLeafCount() const { return m_LeafCount; }
+	/// Height of the root. Leaves alone have height 0.
+	int getHeight() const { return m_Root < 0 ? 0 : m_Nodes[m_Root].m_Height; }
+	/// Ratio of the summed surface area of all nodes to the root surface area. Lower is better.
+	float getAreaRatio() const;
+};
+
+template <class Test, class Visit>
+inline void DynamicAABBTree::traverse(Test&& isOverlapping, Visit&& visit) const
+{
+	if (m_Root < 0)
+	{
+		return;
+	}
+
+	m_Stack.clear();
+	m_Stack.push_back(m_Root);
+	while (!m_Stack.empty())
+	{
+		const Node& node = m_Nodes[m_Stack.back()];
+		m_Stack.pop_back();
+
+		if (!isOverlapping(node.m_Box))
+		{
+			continue;
+		}
+		if (node.isLeaf())
+		{
+			visit(node);
+		}
+		else
+		{
+			m_Stack.push_back(node.m_Child1);
+			m_Stack.push_back(node.m_Child2);
+		}
+	}
+}
+
+template <class Callback>
+inline void DynamicAABBTree::queryBox(const BoundingBox& box, Callback&& callback) const
+{
+	AABB query = AABB::FromBoundingBox(box);
+	traverse(
+	    [&](const AABB& nodeBox) { return query.intersects(nodeBox); },
+	    [&](const Node& leaf) {
+		    if (query.intersects(leaf.m_TightBox))
+		    {
+			    callback(leaf.m_Entity);
+		    }
+	    });
+}
+
+template <class Callback>
+inline void DynamicAABBTree::querySphere(const Vector3& center, float radius, Callback&& callback) const
+{
+	traverse(
+	    [&](const AABB& nodeBox) { return nodeBox.intersects(center, radius); },
+	    [&](const Node& leaf) {
+		    if (leaf.m_TightBox.intersects(center, radius))
+		    {
+			    callback(leaf.m_Entity);
+		    }
+	    });
+}
+
+template <class Callback>
+inline void DynamicAABBTree::queryFrustum(const Frustum& frustum, Callback&& callback) const
+{
+	traverse(
+	    [&](const AABB& nodeBox) { return frustum.intersects(nodeBox); },
+	    [&](const Node& leaf) {
+		    if (frustum.intersects(leaf.m_TightBox))
+		    {
+			    callback(leaf.m_Entity);
+		    }
+	    });
+}
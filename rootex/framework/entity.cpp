@@ -1,22 +1,41 @@
 #include "entity.h"
 
 #include "event_manager.h"
+#include "core/memory_tracker.h"
 #include "framework/component.h"
+#include "framework/entity_query.h"
+#include "framework/entity_command_buffer.h"
+#include "framework/entity_factory.h"
 #include "framework/components/hierarchy_component.h"
 #include "framework/system.h"
 
+static MemoryCounter* GetEntityMemoryCounter()
+{
+	static MemoryCounter* counter = MemoryTracker::GetSingleton()->getCounter("Entities", "Entity");
+	return counter;
+}
+
 void Entity::RegisterAPI(sol::table& rootex)
 {
 	sol::usertype<Entity> entity = rootex.new_usertype<Entity>("Entity");
-	entity["removeComponent"] = &Entity::removeComponent;
-	entity["destroy"] = &Entity::destroy;
+	// Structural changes from scripts are applied after the systems have finished updating
+	entity["removeComponent"] = [](Entity* entity, Component* component) { EntityCommandBuffer::GetSingleton()->removeComponent(entity->getHandle(), component->getComponentID()); };
+	entity["addDefaultComponent"] = [](Entity* entity, const String& componentName) { EntityCommandBuffer::GetSingleton()->addComponent(entity->getHandle(), componentName, JSON::json::object()); };
+	entity["destroy"] = [](Entity* entity) { EntityCommandBuffer::GetSingleton()->deleteEntity(entity->getHandle()); };
 	entity["hasComponent"] = &Entity::hasComponent;
 	entity["getID"] = &Entity::getID;
+	entity["getHandle"] = &Entity::getHandle;
 	entity["getName"] = &Entity::getName;
 	entity["setName"] = &Entity::setName;
 
+	sol::usertype<EntityHandle> entityHandle = rootex.new_usertype<EntityHandle>("EntityHandle");
+	entityHandle["isValid"] = &EntityHandle::isValid;
+	// nil once the entity has been destroyed
+	entityHandle["resolve"] = [](const EntityHandle& handle) { return EntityFactory::GetSingleton()->resolveEntity(handle); };
+
 	sol::usertype<Component> component = rootex.new_usertype<Component>("Component");
-	component["getOwner"] = &Component::getOwner;
+	// Scripts may keep the owner across frames, so they get a handle they resolve on use. Invalid once the component was removed.
+	component["getOwner"] = [](Component* component) { return component->getOwner() ? component->getOwner()->getHandle() : EntityHandle(); };
 	component["getComponentID"] = &Component::getComponentID;
 	component["getName"] = &Component::getName;
 }
@@ -24,19 +43,38 @@ void Entity::RegisterAPI(sol::table& rootex)
 Entity::~Entity()
 {
 	destroy();
+	GetEntityMemoryCounter()->remove(sizeof(Entity));
 }
 
 void Entity::addComponent(const Ref<Component>& component)
 {
-	m_Components.insert(std::make_pair(component->getComponentID(), component));
+	auto&& [insertIt, isInserted] = m_Components.insert(std::make_pair(component->getComponentID(), component));
+	if (isInserted)
+	{
+		m_ComponentSlots[component->getComponentID()] = component.get();
+		m_Signature.set(component->getComponentID());
+		EntityQueryBase::OnSignatureChanged(this);
+	}
 }
 
 Entity::Entity(EntityID id, const String& name, const HashMap<ComponentID, Ref<Component>>& components)
     : m_ID(id)
     , m_Name(name)
     , m_Components(components)
+    , m_ComponentSlots()
+    , m_Signature()
     , m_IsEditorOnly(false)
 {
+	GetEntityMemoryCounter()->add(sizeof(Entity));
+	for (auto& [componentID, component] : m_Components)
+	{
+		m_ComponentSlots[componentID] = component.get();
+		m_Signature.set(componentID);
+	}
+	if (m_Signature.any())
+	{
+		EntityQueryBase::OnSignatureChanged(this);
+	}
 }
 
 JSON::json Entity::getJSON() const
@@ -75,20 +113,28 @@ bool Entity::setupEntities()
 
 void Entity::destroy()
 {
+	EntityQueryBase::OnEntityRemoved(this);
 	for (auto& component : m_Components)
 	{
 		component.second->onRemove();
 		System::DeregisterComponent(component.second.get());
+		component.second->setOwner(nullptr);
 		component.second.reset();
 	}
 	m_Components.clear();
+	std::fill(std::begin(m_ComponentSlots), std::end(m_ComponentSlots), nullptr);
+	m_Signature.reset();
 }
 
 void Entity::removeComponent(Ref<Component> component)
 {
 	component->onRemove();
 	m_Components.erase(component->getComponentID());
+	m_ComponentSlots[component->getComponentID()] = nullptr;
+	m_Signature.reset(component->getComponentID());
+	EntityQueryBase::OnSignatureChanged(this);
 	System::DeregisterComponent(component.get());
+	component->setOwner(nullptr);
 }
 
 EntityID Entity::getID() const
@@ -108,7 +154,7 @@ String Entity::getFullName() const
 
 bool Entity::hasComponent(ComponentID componentID)
 {
-	return m_Components.find(componentID) != m_Components.end();
+	return componentID < (ComponentID)ComponentIDs::Count && m_ComponentSlots[componentID];
 }
 
 void Entity::setName(const String& name)
@@ -3,6 +3,7 @@
 #include "common/common.h"
 #include "script/interpreter.h"
 #include "event.h"
+#include "components/component_ids.h"
 
 class Component;
 
@@ -15,8 +16,13 @@ class Entity
 {
 protected:
 	EntityID m_ID;
+	EntityHandle m_Handle;
 	String m_Name;
 	HashMap<ComponentID, Ref<Component>> m_Components;
+	/// Borrowed pointers into m_Components, indexed by ComponentID, for lookups without hashing or reference counting.
+	Component* m_ComponentSlots[(size_t)ComponentIDs::Count];
+	/// One bit set for every ComponentID present. Used to match the entity against EntityQuery objects.
+	ComponentMask m_Signature;
 	bool m_IsEditorOnly;
 	
 	Entity(EntityID id, const String& name, const HashMap<ComponentID, Ref<Component>>& components = {});
@@ -26,6 +32,7 @@ protected:
 
 	void addComponent(const Ref<Component>& component);
 	friend class EntityFactory;
+	friend class EntityCommandBuffer;
 #ifdef ROOTEX_EDITOR
 	friend class InspectorDock;
 	friend class HierarchyDock;
@@ -41,14 +48,21 @@ public:
 	void destroy();
 
 	bool hasComponent(ComponentID componentID);
+	const ComponentMask& getSignature() const { return m_Signature; }
 	
 	EntityID getID() const;
+	/// Generational handle for referring to this entity without owning it. Invalid until the entity is registered with EntityFactory.
+	const EntityHandle& getHandle() const { return m_Handle; }
 	const String& getName() const;
 	/// Full name consists of entity name followed by the corresponding EntityID.
 	String getFullName() const;
 	
 	template <class ComponentType = Component>
 	Ref<ComponentType> getComponent() const;
+	/// Borrowed pointer to a component, without any heap or reference counting work. Do not hold on to it past the component's removal.
+	/// Components sharing a ComponentID with their base class should be requested as that base class unless their exact type is known.
+	template <class ComponentType = Component>
+	ComponentType* getComponentPtr() const;
 
 	template <class ComponentType = Component>
 	Ref<ComponentType> getComponentFromID(ComponentID ID) const;
@@ -64,6 +78,11 @@ public:
 template <class ComponentType>
 inline Ref<ComponentType> Entity::getComponent() const
 {
+	if (!m_ComponentSlots[ComponentType::s_ID])
+	{
+		return nullptr;
+	}
+
 	auto findIt = m_Components.find(ComponentType::s_ID);
 	if (findIt != m_Components.end())
 	{
@@ -74,6 +93,16 @@ inline Ref<ComponentType> Entity::getComponent() const
 	return nullptr;
 }
 
+template <class ComponentType>
+inline ComponentType* Entity::getComponentPtr() const
+{
+	Component* component = m_ComponentSlots[ComponentType::s_ID];
+#ifdef _DEBUG
+	PANIC(component && !dynamic_cast<ComponentType*>(component), "Component on " + getFullName() + " is not of the requested type");
+#endif // _DEBUG
+	return static_cast<ComponentType*>(component);
+}
+
 template <class ComponentType>
 inline Ref<ComponentType> Entity::getComponentFromID(ComponentID ID) const
 {
@@ -0,0 +1,153 @@
+#include "entity_command_buffer.h"
+
+#include "entity_factory.h"
+#include "system.h"
+
+EntityCommandBuffer* EntityCommandBuffer::GetSingleton()
+{
+	static EntityCommandBuffer singleton;
+	return &singleton;
+}
+
+void EntityCommandBuffer::record(Command&& command)
+{
+	Lock lock(m_Mutex);
+	m_Commands.emplace_back(std::move(command));
+}
+
+void EntityCommandBuffer::createEntity(TextResourceFile* entityFile, const Function<void(Ref<Entity>)>& onCreated)
+{
+	Command command;
+	command.m_Type = Command::Type::CreateEntity;
+	command.m_EntityFile = entityFile;
+	command.m_OnCreated = onCreated;
+	record(std::move(command));
+}
+
+void EntityCommandBuffer::deleteEntity(const EntityHandle& entity)
+{
+	Command command;
+	command.m_Type = Command::Type::DeleteEntity;
+	command.m_Entity = entity;
+	record(std::move(command));
+}
+
+void EntityCommandBuffer::addComponent(const EntityHandle& entity, const String& componentName, const JSON::json& componentData)
+{
+	Command command;
+	command.m_Type = Command::Type::AddComponent;
+	command.m_Entity = entity;
+	command.m_ComponentName = componentName;
+	command.m_ComponentData = componentData;
+	record(std::move(command));
+}
+
+void EntityCommandBuffer::addComponentFromIndex(const EntityHandle& entity, size_t creatorIndex, const JSON::json& componentData)
+{
+	Command command;
+	command.m_Type = Command::Type::AddComponent;
+	command.m_Entity = entity;
+	command.m_ComponentCreatorIndex = creatorIndex;
+	command.m_ComponentData = componentData;
+	record(std::move(command));
+}
+
+void EntityCommandBuffer::removeComponent(const EntityHandle& entity, ComponentID componentID)
+{
+	Command command;
+	command.m_Type = Command::Type::RemoveComponent;
+	command.m_Entity = entity;
+	command.m_ComponentID = componentID;
+	record(std::move(command));
+}
+
+void EntityCommandBuffer::apply()
+{
+	{
+		Lock lock(m_Mutex);
+		if (m_Commands.empty())
+		{
+			return;
+		}
+		m_ApplyingCommands.swap(m_Commands);
+	}
+
+	EntityFactory* factory = EntityFactory::GetSingleton();
+	Vector<EntityHandle> changedEntities;
+	for (Command& command : m_ApplyingCommands)
+	{
+		if (command.m_Type == Command::Type::CreateEntity)
+		{
+			Ref<Entity> entity = factory->createEntity(command.m_EntityFile);
+			if (entity && command.m_OnCreated)
+			{
+				command.m_OnCreated(entity);
+			}
+			continue;
+		}
+
+		Entity* entity = factory->resolveEntity(command.m_Entity);
+		if (!entity)
+		{
+			WARN("Skipped a recorded command for an entity that has already been destroyed");
+			continue;
+		}
+
+		switch (command.m_Type)
+		{
+		case Command::Type::DeleteEntity:
+			factory->deleteEntity(entity);
+			break;
+		case Command::Type::AddComponent:
+		{
+			Ref<Component> component = command.m_ComponentName.empty()
+			    ? factory->createComponentFromIndex(command.m_ComponentCreatorIndex, command.m_ComponentData)
+			    : factory->createComponent(command.m_ComponentName, command.m_ComponentData);
+			if (!component)
+			{
+				break;
+			}
+			if (entity->hasComponent(component->getComponentID()))
+			{
+				WARN("Skipped adding " + component->getName() + " to " + entity->getFullName() + " which already has one");
+				System::DeregisterComponent(component.get());
+				break;
+			}
+			entity->addComponent(component);
+			component->setOwner(entity);
+			if (std::find(changedEntities.begin(), changedEntities.end(), command.m_Entity) == changedEntities.end())
+			{
+				changedEntities.push_back(command.m_Entity);
+			}
+			break;
+		}
+		case Command::Type::RemoveComponent:
+			if (Ref<Component> component = entity->getComponentFromID(command.m_ComponentID))
+			{
+				entity->removeComponent(component);
+				if (std::find(changedEntities.begin(), changedEntities.end(), command.m_Entity) == changedEntities.end())
+				{
+					changedEntities.push_back(command.m_Entity);
+				}
+			}
+			break;
+		default:
+			break;
+		}
+	}
+	m_ApplyingCommands.clear();
+
+	for (auto& handle : changedEntities)
+	{
+		if (Entity* entity = factory->resolveEntity(handle))
+		{
+			entity->setupComponents();
+		}
+	}
+}
+
+void EntityCommandBuffer::clear()
+{
+	Lock lock(m_Mutex);
+	m_Commands.clear();
+}
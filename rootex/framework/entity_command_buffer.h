@@ -0,0 +1,64 @@
+#pragma once
+
+#include "common/common.h"
+#include "entity.h"
+#include "component.h"
+#include "resource_file.h"
+
+/// Records structural changes to entities (creation, deletion, adding and removing components) and applies them
+/// together at a sync point once the frame's systems have finished, so that component lists never change while
+/// systems iterate them. Commands can be recorded from any thread.
+class EntityCommandBuffer
+{
+	struct Command
+	{
+		enum class Type
+		{
+			CreateEntity,
+			DeleteEntity,
+			AddComponent,
+			RemoveComponent
+		};
+
+		Type m_Type;
+		EntityHandle m_Entity;
+		TextResourceFile* m_EntityFile = nullptr;
+		Function<void(Ref<Entity>)> m_OnCreated;
+		/// Component name. Empty if the component is to be created from m_ComponentCreatorIndex.
+		String m_ComponentName;
+		/// Position of the component class in the EntityFactory creator tables, see ComponentCreatorIndex.
+		size_t m_ComponentCreatorIndex = 0;
+		ComponentID m_ComponentID = 0;
+		JSON::json m_ComponentData;
+	};
+
+	Mutex m_Mutex;
+	Vector<Command> m_Commands;
+	/// Commands being applied. Kept around to reuse its allocation.
+	Vector<Command> m_ApplyingCommands;
+
+	EntityCommandBuffer() = default;
+	EntityCommandBuffer(EntityCommandBuffer&) = delete;
+	~EntityCommandBuffer() = default;
+
+	void record(Command&& command);
+	void addComponentFromIndex(const EntityHandle& entity, size_t creatorIndex, const JSON::json& componentData);
+
+public:
+	static EntityCommandBuffer* GetSingleton();
+
+	/// onCreated is called with the new entity when the command is applied.
+	void createEntity(TextResourceFile* entityFile, const Function<void(Ref<Entity>)>& onCreated = {});
+	void deleteEntity(const EntityHandle& entity);
+	void addComponent(const EntityHandle& entity, const String& componentName, const JSON::json& componentData);
+	/// Add a component of ComponentClass without matching its name. Works for classes sharing a ComponentID too.
+	template <class ComponentClass>
+	void addComponent(const EntityHandle& entity, const JSON::json& componentData) { addComponentFromIndex(entity, ComponentCreatorIndex<ComponentClass>::s_Value, componentData); }
+	void removeComponent(const EntityHandle& entity, ComponentID componentID);
+
+	/// Apply all commands recorded so far, in recording order. Commands recorded while applying are left for the next call.
+	/// Entities that gained or lost components are set up once after all commands have been applied.
+	void apply();
+	/// Drop all recorded commands.
+	void clear();
+};
@@ -4,6 +4,8 @@
 
 #include "component.h"
 #include "entity.h"
+#include "entity_command_buffer.h"
+#include "entity_query.h"
 #include "system.h"
 
 #include "components/audio_listener_component.h"
@@ -31,9 +33,10 @@
 #include "components/visual/ui_component.h"
 #include "systems/hierarchy_system.h"
 
-#define REGISTER_COMPONENT(ComponentClass)                                                            \
-	m_ComponentCreators.push_back({ ComponentClass::s_ID, #ComponentClass, ComponentClass::Create }); \
-	m_DefaultComponentCreators.push_back({ ComponentClass::s_ID, #ComponentClass, ComponentClass::CreateDefault })
+#define REGISTER_COMPONENT(ComponentClass)                                                                            \
+	ComponentCreatorIndex<ComponentClass>::s_Value = m_ComponentCreators.size();                                      \
+	registerComponent(ComponentClass::s_ID, #ComponentClass, ComponentClass::Create, ComponentClass::CreateDefault); \
+	ComponentPool<ComponentClass>::GetSingleton()->registerMemoryCounters(#ComponentClass)
 
 EntityID EntityFactory::s_CurrentID = ROOT_ENTITY_ID;
 EntityID EntityFactory::s_CurrentEditorID = -ROOT_ENTITY_ID;
@@ -44,6 +47,7 @@ void EntityFactory::RegisterAPI(sol::table& rootex)
 	entityFactory["Create"] = [](TextResourceFile* t) { return EntityFactory::GetSingleton()->createEntity(t); };
 	entityFactory["CreateFromClass"] = [](TextResourceFile* t) { return EntityFactory::GetSingleton()->createEntityFromClass(t); };
 	entityFactory["Find"] = [](EntityID e) { return EntityFactory::GetSingleton()->findEntity(e); };
+	entityFactory["Resolve"] = [](const EntityHandle& h) { return EntityFactory::GetSingleton()->resolveEntity(h); };
 }
 
 EntityFactory* EntityFactory::GetSingleton()
@@ -62,6 +66,39 @@ EntityID EntityFactory::getNextEditorID()
 	return --s_CurrentEditorID;
 }
 
+void EntityFactory::acquireHandle(Entity* entity)
+{
+	if (m_FreeEntitySlots.empty())
+	{
+		m_FreeEntitySlots.push_back((unsigned int)m_EntitySlots.size());
+		m_EntitySlots.push_back({ nullptr, 1 });
+	}
+
+	unsigned int index = m_FreeEntitySlots.back();
+	m_FreeEntitySlots.pop_back();
+
+	EntitySlot& slot = m_EntitySlots[index];
+	slot.m_Entity = entity;
+	entity->m_Handle = { index, slot.m_Generation };
+}
+
+void EntityFactory::releaseHandle(Entity* entity)
+{
+	if (resolveEntity(entity->m_Handle) != entity)
+	{
+		return;
+	}
+
+	EntitySlot& slot = m_EntitySlots[entity->m_Handle.m_Index];
+	slot.m_Entity = nullptr;
+	if (++slot.m_Generation == 0)
+	{
+		slot.m_Generation = 1;
+	}
+	m_FreeEntitySlots.push_back(entity->m_Handle.m_Index);
+	entity->m_Handle = {};
+}
+
 EntityFactory::EntityFactory()
 {
 	BIND_EVENT_MEMBER_FUNCTION("DeleteEntity", deleteEntityEvent);
@@ -92,24 +129,53 @@ EntityFactory::EntityFactory()
 	REGISTER_COMPONENT(UIComponent);
 }
 
-Ref<Component> EntityFactory::createComponent(const String& name, const JSON::json& componentData)
+void EntityFactory::registerComponent(ComponentID componentID, const String& name, ComponentCreator creator, ComponentDefaultCreator defaultCreator)
+{
+	size_t index = m_ComponentCreators.size();
+	m_ComponentCreators.push_back({ componentID, name, creator });
+	m_DefaultComponentCreators.push_back({ componentID, name, defaultCreator });
+
+	m_ComponentIndicesByName[name] = index;
+}
+
+Ref<Component> EntityFactory::createComponentFromIndex(size_t index, const JSON::json& componentData)
 {
-	auto& findIt = m_ComponentCreators.end();
-	for (auto& componentClass = m_ComponentCreators.begin(); componentClass != m_ComponentCreators.end(); componentClass++)
+	if (index >= m_ComponentCreators.size())
 	{
-		if (Extract(String, *componentClass) == name)
-		{
-			findIt = componentClass;
-		}
+		ERR("Could not find component creator for an unregistered component class");
+		return nullptr;
 	}
-	if (findIt != m_ComponentCreators.end())
+
+	ComponentCreator create = Extract(ComponentCreator, m_ComponentCreators[index]);
+	Ref<Component> component(create(componentData));
+
+	System::RegisterComponent(component.get());
+
+	return component;
+}
+
+Ref<Component> EntityFactory::createDefaultComponentFromIndex(size_t index)
+{
+	if (index >= m_DefaultComponentCreators.size())
 	{
-		ComponentCreator create = Extract(ComponentCreator, *findIt);
-		Ref<Component> component(create(componentData));
+		ERR("Could not find default component creator for an unregistered component class");
+		return nullptr;
+	}
+
+	ComponentDefaultCreator create = Extract(ComponentDefaultCreator, m_DefaultComponentCreators[index]);
+	Ref<Component> component(create());
 
-		System::RegisterComponent(component.get());
+	System::RegisterComponent(component.get());
+
+	return component;
+}
 
-		return component;
+Ref<Component> EntityFactory::createComponent(const String& name, const JSON::json& componentData)
+{
+	auto&& findIt = m_ComponentIndicesByName.find(name);
+	if (findIt != m_ComponentIndicesByName.end())
+	{
+		return createComponentFromIndex(findIt->second, componentData);
 	}
 	else
 	{
@@ -120,22 +186,10 @@ Ref<Component> EntityFactory::createComponent(const String& name, const JSON::js
 
 Ref<Component> EntityFactory::createDefaultComponent(const String& name)
 {
-	auto& findIt = m_DefaultComponentCreators.end();
-	for (auto& componentClass = m_DefaultComponentCreators.begin(); componentClass != m_DefaultComponentCreators.end(); componentClass++)
+	auto&& findIt = m_ComponentIndicesByName.find(name);
+	if (findIt != m_ComponentIndicesByName.end())
 	{
-		if (Extract(String, *componentClass) == name)
-		{
-			findIt = componentClass;
-		}
-	}
-	if (findIt != m_DefaultComponentCreators.end())
-	{
-		ComponentDefaultCreator create = Extract(ComponentDefaultCreator, *findIt);
-		Ref<Component> component(create());
-
-		System::RegisterComponent(component.get());
-
-		return component;
+		return createDefaultComponentFromIndex(findIt->second);
 	}
 	else
 	{
@@ -197,7 +251,7 @@ Ref<Entity> EntityFactory::createEntity(const JSON::json& entityJSON, const Stri
 		if (componentObject)
 		{
 			entity->addComponent(componentObject);
-			componentObject->setOwner(entity);
+			componentObject->setOwner(entity.get());
 		}
 	}
 
@@ -209,6 +263,7 @@ Ref<Entity> EntityFactory::createEntity(const JSON::json& entityJSON, const Stri
 	entity->setEditorOnly(isEditorOnly);
 
 	m_Entities[entity->m_ID] = entity;
+	acquireHandle(entity.get());
 
 	PRINT("Created entity: " + entity->getFullName());
 
@@ -226,6 +281,21 @@ Ref<Entity> EntityFactory::findEntity(EntityID entityID)
 	return nullptr;
 }
 
+Entity* EntityFactory::resolveEntity(const EntityHandle& handle) const
+{
+	if (handle.m_Index >= m_EntitySlots.size())
+	{
+		return nullptr;
+	}
+
+	const EntitySlot& slot = m_EntitySlots[handle.m_Index];
+	if (slot.m_Generation != handle.m_Generation)
+	{
+		return nullptr;
+	}
+	return slot.m_Entity;
+}
+
 void EntityFactory::setupLiveEntities()
 {
 	for (auto& entity : m_Entities)
@@ -242,33 +312,34 @@ Ref<Entity> EntityFactory::createRootEntity()
 	{
 		Ref<HierarchyComponent> rootComponent(new HierarchyComponent(INVALID_ID, {}));
 		System::RegisterComponent(rootComponent.get());
-		addComponent(root, rootComponent);
+		addComponent(root.get(), rootComponent);
 	}
 	{
 		Ref<Component> rootTransformComponent = createDefaultComponent("TransformComponent");
-		addComponent(root, rootTransformComponent);
+		addComponent(root.get(), rootTransformComponent);
 	}
 	{
 		Ref<ModelComponent> rootModelComponent = std::dynamic_pointer_cast<ModelComponent>(createDefaultComponent("ModelComponent"));
 		rootModelComponent->setIsVisible(false);
-		addComponent(root, rootModelComponent);
+		addComponent(root.get(), rootModelComponent);
 	}
 	{
 		Ref<CameraComponent> rootCameraComponent = std::dynamic_pointer_cast<CameraComponent>(createDefaultComponent("CameraComponent"));
-		addComponent(root, rootCameraComponent);
+		addComponent(root.get(), rootCameraComponent);
 	}
 	{
 		Ref<AudioListenerComponent> rootListenerComponent = std::dynamic_pointer_cast<AudioListenerComponent>(createDefaultComponent("AudioListenerComponent"));
-		addComponent(root, rootListenerComponent);
+		addComponent(root.get(), rootListenerComponent);
 	}
 
 	m_Entities[root->m_ID] = root;
+	acquireHandle(root.get());
 	return root;
 }
 
 Variant EntityFactory::deleteEntityEvent(const Event* event)
 {
-	deleteEntity(Extract(Ref<Entity>, event->getData()));
+	EntityCommandBuffer::GetSingleton()->deleteEntity(Extract(EntityHandle, event->getData()));
 	return true;
 }
 
@@ -278,12 +349,12 @@ Variant EntityFactory::applicationExit(const Event* event)
 	return true;
 }
 
-void EntityFactory::addDefaultComponent(Ref<Entity> entity, String componentName)
+void EntityFactory::addDefaultComponent(Entity* entity, String componentName)
 {
 	addComponent(entity, createDefaultComponent(componentName));
 }
 
-void EntityFactory::addComponent(Ref<Entity> entity, Ref<Component> component)
+void EntityFactory::addComponent(Entity* entity, Ref<Component> component)
 {
 	entity->addComponent(component);
 	component->setOwner(entity);
@@ -292,13 +363,19 @@ void EntityFactory::addComponent(Ref<Entity> entity, Ref<Component> component)
 
 void EntityFactory::destroyEntities()
 {
+	static auto isPersistent = [](const Entity* entity) {
+		return entity->getID() == ROOT_ENTITY_ID || entity->getID() == INVALID_ID || entity->isEditorOnly();
+	};
+
 	Vector<Ref<Entity>> markedForRemoval;
+	Vector<Ref<Entity>> persistent;
 	for (auto& entity : m_Entities)
 	{
 		if (entity.second)
 		{
-			if (entity.second->getID() == ROOT_ENTITY_ID || entity.second->getID() == INVALID_ID || entity.second->isEditorOnly())
+			if (isPersistent(entity.second.get()))
 			{
+				persistent.push_back(entity.second);
 				continue;
 			}
 
@@ -310,24 +387,75 @@ void EntityFactory::destroyEntities()
 		}
 	}
 
+	// Unlink the whole destroyed set from the surviving hierarchy at once instead of
+	// letting every HierarchyComponent::onRemove() search and erase from its parent.
+	for (auto&& entity : persistent)
+	{
+		if (HierarchyComponent* hierarchy = entity->getComponentPtr<HierarchyComponent>())
+		{
+			Vector<HierarchyComponent*>& children = hierarchy->m_Children;
+			children.erase(std::remove_if(children.begin(), children.end(), [](HierarchyComponent* child) {
+				return !isPersistent(child->getOwner());
+			}),
+			    children.end());
+			hierarchy->m_ChildrenIDs.clear();
+			for (HierarchyComponent* child : children)
+			{
+				hierarchy->m_ChildrenIDs.push_back(child->getOwner()->getID());
+			}
+		}
+	}
+	HierarchySystem::InvalidateHierarchy();
+	for (auto&& entity : markedForRemoval)
+	{
+		if (HierarchyComponent* hierarchy = entity->getComponentPtr<HierarchyComponent>())
+		{
+			hierarchy->clear();
+		}
+		for (auto& [componentID, component] : entity->m_Components)
+		{
+			component->onRemove();
+		}
+	}
+
+	System::DeregisterComponents([](Component* component) {
+		return component->getOwner() && !isPersistent(component->getOwner());
+	});
+
 	for (auto&& entity : markedForRemoval)
 	{
-		deleteEntity(entity);
+		EntityQueryBase::OnEntityRemoved(entity.get());
+		for (auto& [componentID, component] : entity->m_Components)
+		{
+			component->setOwner(nullptr);
+		}
+		entity->m_Components.clear();
+		std::fill(std::begin(entity->m_ComponentSlots), std::end(entity->m_ComponentSlots), nullptr);
+		entity->m_Signature.reset();
 	}
+	markedForRemoval.clear();
 
 	Ref<Entity> root = m_Entities[ROOT_ENTITY_ID];
+	for (auto& [entityID, entity] : m_Entities)
+	{
+		if (entity && entity != root)
+		{
+			releaseHandle(entity.get());
+		}
+	}
 	m_Entities.clear();
 	m_Entities[ROOT_ENTITY_ID] = root;
 }
 
-void EntityFactory::deleteEntity(Ref<Entity> entity)
+void EntityFactory::deleteEntity(Entity* entity)
 {
 	entity->destroy();
+	releaseHandle(entity);
+	// May release the last reference to the entity
 	m_Entities.erase(entity->getID());
-	entity.reset();
 }
 
-bool EntityFactory::saveEntityAsClass(Ref<Entity> entity)
+bool EntityFactory::saveEntityAsClass(Entity* entity)
 {
 	if (OS::IsExists("game/assets/classes/" + entity->getName()))
 	{
@@ -343,10 +471,10 @@ bool EntityFactory::saveEntityAsClass(Ref<Entity> entity)
 	return true;
 }
 
-bool EntityFactory::copyEntity(Ref<Entity> entity)
+bool EntityFactory::copyEntity(Entity* entity)
 {
 	Ref<Entity> createdEntity = createEntitiesRecursively(entity);
-	fixParentID(createdEntity, entity->getComponent<HierarchyComponent>()->m_ParentID);
+	fixParentID(createdEntity.get(), entity->getComponentPtr<HierarchyComponent>()->m_ParentID);
 	if (!createdEntity)
 	{
 		WARN("Could not create entity:" + createdEntity->getName());
@@ -354,14 +482,14 @@ bool EntityFactory::copyEntity(Ref<Entity> entity)
 	return true;
 }
 
-Ref<Entity> EntityFactory::createEntitiesRecursively(Ref<Entity> entity)
+Ref<Entity> EntityFactory::createEntitiesRecursively(Entity* entity)
 {
 	Ref<HierarchyComponent> hierarchyComponent = entity->getComponent<HierarchyComponent>();
 	JSON::json& entityJSON = entity->getJSON();
 	Vector<EntityID> childrenIDs;
 	for (EntityID child : hierarchyComponent->m_ChildrenIDs)
 	{
-		createEntitiesRecursively(findEntity(child));
+		createEntitiesRecursively(findEntity(child).get());
 		childrenIDs.push_back(child);
 	}
 	entityJSON["Components"]["HierarchyComponent"]["children"] = childrenIDs;
@@ -375,14 +503,14 @@ Ref<Entity> EntityFactory::createEntitiesRecursively(Ref<Entity> entity)
 	return newEntity;
 }
 
-String EntityFactory::saveEntityAsClassRecursively(Ref<Entity> entity, const String& path)
+String EntityFactory::saveEntityAsClassRecursively(Entity* entity, const String& path)
 {
 	Ref<HierarchyComponent> hierarchyComponent = entity->getComponent<HierarchyComponent>();
 	JSON::json& entityJSON = entity->getJSON();
 	Vector<String> children;
 	for (EntityID child : hierarchyComponent->m_ChildrenIDs)
 	{
-		children.push_back(saveEntityAsClassRecursively(EntityFactory::GetSingleton()->findEntity(child), path));
+		children.push_back(saveEntityAsClassRecursively(EntityFactory::GetSingleton()->findEntity(child).get(), path));
 	}
 	entityJSON["Components"]["HierarchyComponent"]["children"] = children;
 	entityJSON["Components"]["HierarchyComponent"]["parent"] = ROOT_ENTITY_ID;
@@ -402,7 +530,7 @@ Ref<Entity> EntityFactory::createEntityFromClass(TextResourceFile* entityFile)
 Ref<Entity> EntityFactory::createEntityFromClass(const JSON::json& entityJSON)
 {
 	Ref<Entity> createdEntity = createEntityHierarchyFromClass(entityJSON);
-	fixParentID(createdEntity, ROOT_ENTITY_ID);
+	fixParentID(createdEntity.get(), ROOT_ENTITY_ID);
 	return createdEntity;
 }
 
@@ -430,13 +558,13 @@ Ref<Entity> EntityFactory::createEntityHierarchyFromClass(JSON::json entityJSON)
 	return newEntity;
 }
 
-void EntityFactory::fixParentID(Ref<Entity> entity, EntityID id)
+void EntityFactory::fixParentID(Entity* entity, EntityID id)
 {
 	Ref<HierarchyComponent> hierarchyComponent = entity->getComponent<HierarchyComponent>();
 	hierarchyComponent->m_ParentID = id;
 	entity->setupEntities();
 	for (EntityID childID : hierarchyComponent->m_ChildrenIDs)
 	{
-		fixParentID(findEntity(childID), entity->getID());
+		fixParentID(findEntity(childID).get(), entity->getID());
 	}
 }
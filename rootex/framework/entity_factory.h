@@ -25,17 +25,34 @@ class EntityFactory
 	static EntityID s_CurrentID;
 	static EntityID s_CurrentEditorID;
 
+	/// Entry in the handle table. The generation is bumped every time the slot is released, invalidating outstanding handles.
+	struct EntitySlot
+	{
+		Entity* m_Entity;
+		unsigned int m_Generation;
+	};
+
 	HashMap<EntityID, Ref<Entity>> m_Entities;
+	Vector<EntitySlot> m_EntitySlots;
+	Vector<unsigned int> m_FreeEntitySlots;
 
 	EntityID getNextID();
 	EntityID getNextEditorID();
-	String saveEntityAsClassRecursively(Ref<Entity> entity, const String& path);
+	/// Give the entity a live handle.
+	void acquireHandle(Entity* entity);
+	/// Invalidate the entity's handle and recycle its slot.
+	void releaseHandle(Entity* entity);
+	String saveEntityAsClassRecursively(Entity* entity, const String& path);
 	Ref<Entity> createEntityHierarchyFromClass(JSON::json entityJSON);
-	void fixParentID(Ref<Entity> entity, EntityID id);
+	void fixParentID(Entity* entity, EntityID id);
 
 protected:
 	ComponentDatabase m_ComponentCreators;
 	DefaultComponentDatabase m_DefaultComponentCreators;
+	/// Positions inside the component databases, keyed by component class name.
+	HashMap<String, size_t> m_ComponentIndicesByName;
+
+	void registerComponent(ComponentID componentID, const String& name, ComponentCreator creator, ComponentDefaultCreator defaultCreator);
 
 	EntityFactory();
 	EntityFactory(EntityFactory&) = delete;
@@ -53,21 +70,31 @@ public:
 
 	Ref<Component> createComponent(const String& name, const JSON::json& componentData);
 	Ref<Component> createDefaultComponent(const String& name);
+	/// Create a component from the position of its class in the component databases, see ComponentCreatorIndex.
+	Ref<Component> createComponentFromIndex(size_t index, const JSON::json& componentData);
+	Ref<Component> createDefaultComponentFromIndex(size_t index);
+	/// Create a component of ComponentClass without matching its name. Works for classes sharing a ComponentID too.
+	template <class ComponentClass>
+	Ref<ComponentClass> createComponent(const JSON::json& componentData);
+	template <class ComponentClass>
+	Ref<ComponentClass> createDefaultComponent();
 	Ref<Entity> createEntity(const JSON::json& entityJSON, const String& filePath, bool isEditorOnly = false);
 	Ref<Entity> createEntity(TextResourceFile* textResourceFile, bool isEditorOnly = false);
 	/// Get entity by ID.
 	Ref<Entity> findEntity(EntityID entityID);
+	/// Get entity by handle in O(1). Returns nullptr if the entity has been destroyed since the handle was taken.
+	Entity* resolveEntity(const EntityHandle& handle) const;
 
 	void setupLiveEntities();
 
-	void addDefaultComponent(Ref<Entity> entity, String componentName);
-	void addComponent(Ref<Entity> entity, Ref<Component> component);
+	void addDefaultComponent(Entity* entity, String componentName);
+	void addComponent(Entity* entity, Ref<Component> component);
 	/// Delete all non-Root entities.
 	void destroyEntities();
-	void deleteEntity(Ref<Entity> entity);
-	bool saveEntityAsClass(Ref<Entity> entity);
-	bool copyEntity(Ref<Entity> entity);
-	Ref<Entity> createEntitiesRecursively(Ref<Entity> entity);
+	void deleteEntity(Entity* entity);
+	bool saveEntityAsClass(Entity* entity);
+	bool copyEntity(Entity* entity);
+	Ref<Entity> createEntitiesRecursively(Entity* entity);
 	Ref<Entity> createEntityFromClass(const JSON::json& entityJSON);
 	Ref<Entity> createEntityFromClass(TextResourceFile* entityJSON);
 
@@ -75,3 +102,15 @@ public:
 	const HashMap<EntityID, Ref<Entity>>& getEntities() const { return m_Entities; }
 	HashMap<EntityID, Ref<Entity>>& getMutableEntities() { return m_Entities; }
 };
+
+template <class ComponentClass>
+Ref<ComponentClass> EntityFactory::createComponent(const JSON::json& componentData)
+{
+	return std::static_pointer_cast<ComponentClass>(createComponentFromIndex(ComponentCreatorIndex<ComponentClass>::s_Value, componentData));
+}
+
+template <class ComponentClass>
+Ref<ComponentClass> EntityFactory::createDefaultComponent()
+{
+	return std::static_pointer_cast<ComponentClass>(createDefaultComponentFromIndex(ComponentCreatorIndex<ComponentClass>::s_Value));
+}
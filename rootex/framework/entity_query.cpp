@@ -0,0 +1,91 @@
+#include "entity_query.h"
+
+#include "entity_factory.h"
+
+Vector<EntityQueryBase*>& EntityQueryBase::GetQueries()
+{
+	static Vector<EntityQueryBase*>* queries = new Vector<EntityQueryBase*>();
+	return *queries;
+}
+
+EntityQueryBase::EntityQueryBase(const ComponentMask& signature)
+    : m_Signature(signature)
+{
+	GetQueries().push_back(this);
+}
+
+EntityQueryBase::~EntityQueryBase()
+{
+	Vector<EntityQueryBase*>& queries = GetQueries();
+	auto&& findIt = std::find(queries.begin(), queries.end(), this);
+	if (findIt != queries.end())
+	{
+		queries.erase(findIt);
+	}
+}
+
+void EntityQueryBase::add(Entity* entity)
+{
+	if (m_Indices.find(entity) != m_Indices.end())
+	{
+		return;
+	}
+
+	m_Indices[entity] = m_Entities.size();
+	m_Entities.push_back(entity);
+	addMatch(entity);
+}
+
+void EntityQueryBase::remove(const Entity* entity)
+{
+	auto&& findIt = m_Indices.find(entity);
+	if (findIt == m_Indices.end())
+	{
+		return;
+	}
+
+	size_t index = findIt->second;
+	m_Indices.erase(findIt);
+
+	removeMatch(index);
+	m_Entities[index] = m_Entities.back();
+	m_Entities.pop_back();
+	if (index < m_Entities.size())
+	{
+		m_Indices[m_Entities[index]] = index;
+	}
+}
+
+void EntityQueryBase::populate()
+{
+	for (auto&& [entityID, entity] : EntityFactory::GetSingleton()->getEntities())
+	{
+		if ((entity->getSignature() & m_Signature) == m_Signature)
+		{
+			add(entity.get());
+		}
+	}
+}
+
+void EntityQueryBase::OnSignatureChanged(Entity* entity)
+{
+	for (EntityQueryBase* query : GetQueries())
+	{
+		if ((entity->getSignature() & query->m_Signature) == query->m_Signature)
+		{
+			query->add(entity);
+		}
+		else
+		{
+			query->remove(entity);
+		}
+	}
+}
+
+void EntityQueryBase::OnEntityRemoved(const Entity* entity)
+{
+	for (EntityQueryBase* query : GetQueries())
+	{
+		query->remove(entity);
+	}
+}
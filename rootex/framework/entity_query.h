@@ -0,0 +1,82 @@
+#pragma once
+
+#include "common/common.h"
+#include "entity.h"
+
+/// Type independent part of EntityQuery. Keeps the cached matches of every live query in sync with entity signatures.
+class EntityQueryBase
+{
+	ComponentMask m_Signature;
+	Vector<Entity*> m_Entities;
+	HashMap<const Entity*, size_t> m_Indices;
+
+	/// Never destroyed so that entities released during static destruction can still unregister themselves.
+	static Vector<EntityQueryBase*>& GetQueries();
+
+	void add(Entity* entity);
+	void remove(const Entity* entity);
+
+protected:
+	EntityQueryBase(const ComponentMask& signature);
+	EntityQueryBase(EntityQueryBase&) = delete;
+	virtual ~EntityQueryBase();
+
+	virtual void addMatch(Entity* entity) = 0;
+	/// Remove the match at index by moving the last match into its place.
+	virtual void removeMatch(size_t index) = 0;
+
+	/// Match already existing entities. Called by EntityQuery once it has been fully constructed.
+	void populate();
+
+public:
+	/// Re-evaluate an entity against every query after its set of components changed.
+	static void OnSignatureChanged(Entity* entity);
+	/// Drop an entity from every query before it is destroyed.
+	static void OnEntityRemoved(const Entity* entity);
+
+	const ComponentMask& getSignature() const { return m_Signature; }
+	/// Matching entities, in the same order as the matches of the derived EntityQuery.
+	const Vector<Entity*>& getEntities() const { return m_Entities; }
+	size_t size() const { return m_Entities.size(); }
+};
+
+/// Cached list of all entities having every one of ComponentTypes, along with pointers to those components.
+/// Matches are updated incrementally when components are added or removed, so iterating them involves no lookups.
+/// Components sharing a ComponentID with other classes should be requested as their base class.
+template <class... ComponentTypes>
+class EntityQuery : public EntityQueryBase
+{
+public:
+	typedef Tuple<ComponentTypes*...> Match;
+
+private:
+	Vector<Match> m_Matches;
+
+	static ComponentMask MakeSignature()
+	{
+		ComponentMask signature;
+		(signature.set(ComponentTypes::s_ID), ...);
+		return signature;
+	}
+
+protected:
+	void addMatch(Entity* entity) override { m_Matches.emplace_back(entity->getComponentPtr<ComponentTypes>()...); }
+	void removeMatch(size_t index) override
+	{
+		m_Matches[index] = m_Matches.back();
+		m_Matches.pop_back();
+	}
+
+public:
+	EntityQuery()
+	    : EntityQueryBase(MakeSignature())
+	{
+		populate();
+	}
+	EntityQuery(EntityQuery&) = delete;
+	~EntityQuery() = default;
+
+	const Vector<Match>& getMatches() const { return m_Matches; }
+	typename Vector<Match>::const_iterator begin() const { return m_Matches.begin(); }
+	typename Vector<Match>::const_iterator end() const { return m_Matches.end(); }
+};
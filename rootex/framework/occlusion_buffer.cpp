@@ -0,0 +1,314 @@
+#include "occlusion_buffer.h"
+
+#include "os/thread.h"
+
+#include <xmmintrin.h>
+
+/// Clip space w below which vertices are considered to be on or behind the near plane.
+static const float NearW = 1e-4f;
+
+static void WriteLittleEndian(Vector<char>& bytes, unsigned int value, int size)
+{
+	for (int i = 0; i < size; i++)
+	{
+		bytes.push_back((char)((value >> (8 * i)) & 0xFF));
+	}
+}
+
+OcclusionBuffer::OcclusionBuffer(int width, int height)
+    : m_Width((width + 3) & ~3)
+    , m_Height(height)
+    , m_Depths(m_Width * m_Height, 1.0f)
+{
+}
+
+Vector4 OcclusionBuffer::project(const Vector3& position, const Matrix& transform) const
+{
+	const Matrix& m = transform;
+	float x = position.x * m._11 + position.y * m._21 + position.z * m._31 + m._41;
+	float y = position.x * m._12 + position.y * m._22 + position.z * m._32 + m._42;
+	float z = position.x * m._13 + position.y * m._23 + position.z * m._33 + m._43;
+	float w = position.x * m._14 + position.y * m._24 + position.z * m._34 + m._44;
+	if (w <= NearW)
+	{
+		return { 0.0f, 0.0f, 0.0f, w };
+	}
+
+	float inverseW = 1.0f / w;
+	return {
+		(x * inverseW * 0.5f + 0.5f) * m_Width,
+		(0.5f - y * inverseW * 0.5f) * m_Height,
+		z * inverseW,
+		w
+	};
+}
+
+void OcclusionBuffer::begin(const Matrix& viewProjection)
+{
+	m_ViewProjection = viewProjection;
+	m_Triangles.clear();
+	std::fill(m_Depths.begin(), m_Depths.end(), 1.0f);
+}
+
+void OcclusionBuffer::addOccluder(const Vector<Vector3>& positions, const Vector<unsigned int>& indices, const Matrix& world)
+{
+	const Matrix transform = world * m_ViewProjection;
+	m_ScreenVertices.resize(positions.size());
+	for (size_t i = 0; i < positions.size(); i++)
+	{
+		m_ScreenVertices[i] = project(positions[i], transform);
+	}
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		const Vector4& a = m_ScreenVertices[indices[i]];
+		const Vector4& b = m_ScreenVertices[indices[i + 1]];
+		const Vector4& c = m_ScreenVertices[indices[i + 2]];
+		if (a.w <= NearW || b.w <= NearW || c.w <= NearW)
+		{
+			continue;
+		}
+
+		ScreenTriangle triangle;
+		triangle.m_Vertices[0] = { a.x, a.y, a.z };
+		triangle.m_Vertices[1] = { b.x, b.y, b.z };
+		triangle.m_Vertices[2] = { c.x, c.y, c.z };
+		triangle.m_Area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+		if (triangle.m_Area < 0.0f)
+		{
+			std::swap(triangle.m_Vertices[1], triangle.m_Vertices[2]);
+			triangle.m_Area = -triangle.m_Area;
+		}
+		if (triangle.m_Area < 1e-6f)
+		{
+			continue;
+		}
+
+		float minX = a.x < b.x ? (a.x < c.x ? a.x : c.x) : (b.x < c.x ? b.x : c.x);
+		float maxX = a.x > b.x ? (a.x > c.x ? a.x : c.x) : (b.x > c.x ? b.x : c.x);
+		float minY = a.y < b.y ? (a.y < c.y ? a.y : c.y) : (b.y < c.y ? b.y : c.y);
+		float maxY = a.y > b.y ? (a.y > c.y ? a.y : c.y) : (b.y > c.y ? b.y : c.y);
+		if (maxX < 0.0f || maxY < 0.0f || minX >= m_Width || minY >= m_Height)
+		{
+			continue;
+		}
+
+		triangle.m_MinX = minX < 0.0f ? 0 : (int)minX;
+		triangle.m_MinY = minY < 0.0f ? 0 : (int)minY;
+		triangle.m_MaxX = maxX >= m_Width ? m_Width - 1 : (int)maxX;
+		triangle.m_MaxY = maxY >= m_Height ? m_Height - 1 : (int)maxY;
+		m_Triangles.push_back(triangle);
+	}
+}
+
+void OcclusionBuffer::rasterize(ThreadPool* threadPool)
+{
+	if (!threadPool || threadPool->getThreadCount() == 0)
+	{
+		rasterizeBand(0, m_Height);
+		return;
+	}
+
+	// Bands never share pixels, so they can be written without synchronisation
+	m_Tasks.clear();
+	for (int rowBegin = 0; rowBegin < m_Height; rowBegin += OCCLUSION_BUFFER_BAND_HEIGHT)
+	{
+		int rowEnd = rowBegin + OCCLUSION_BUFFER_BAND_HEIGHT;
+		if (rowEnd > m_Height)
+		{
+			rowEnd = m_Height;
+		}
+		m_Tasks.emplace_back(new Task([this, rowBegin, rowEnd]() { rasterizeBand(rowBegin, rowEnd); }));
+	}
+	threadPool->execute(m_Tasks);
+}
+
+void OcclusionBuffer::rasterizeBand(int rowBegin, int rowEnd)
+{
+	const __m128 laneCenters = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (const ScreenTriangle& triangle : m_Triangles)
+	{
+		int yBegin = triangle.m_MinY > rowBegin ? triangle.m_MinY : rowBegin;
+		int yEnd = triangle.m_MaxY < rowEnd - 1 ? triangle.m_MaxY : rowEnd - 1;
+		if (yBegin > yEnd)
+		{
+			continue;
+		}
+
+		const Vector3& v0 = triangle.m_Vertices[0];
+		const Vector3& v1 = triangle.m_Vertices[1];
+		const Vector3& v2 = triangle.m_Vertices[2];
+
+		// Edge function of edge a to b at p is (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x), positive inside.
+		// Weight i belongs to the edge opposite to vertex i, so the weights are barycentric coordinates scaled by the area.
+		const Vector3* edgeStarts[3] = { &v1, &v2, &v0 };
+		const Vector3* edgeEnds[3] = { &v2, &v0, &v1 };
+		float stepX[3];
+		float stepY[3];
+		for (int e = 0; e < 3; e++)
+		{
+			stepY[e] = edgeEnds[e]->x - edgeStarts[e]->x;
+			stepX[e] = edgeEnds[e]->y - edgeStarts[e]->y;
+		}
+
+		const float inverseArea = 1.0f / triangle.m_Area;
+		const __m128 z0 = _mm_set1_ps(v0.z * inverseArea);
+		const __m128 z1 = _mm_set1_ps(v1.z * inverseArea);
+		const __m128 z2 = _mm_set1_ps(v2.z * inverseArea);
+		const __m128 stepX0 = _mm_set1_ps(stepX[0]);
+		const __m128 stepX1 = _mm_set1_ps(stepX[1]);
+		const __m128 stepX2 = _mm_set1_ps(stepX[2]);
+
+		const int xBegin = triangle.m_MinX & ~3;
+		for (int y = yBegin; y <= yEnd; y++)
+		{
+			float pixelY = y + 0.5f;
+			__m128 rowWeight0 = _mm_set1_ps(stepY[0] * (pixelY - edgeStarts[0]->y) + stepX[0] * edgeStarts[0]->x);
+			__m128 rowWeight1 = _mm_set1_ps(stepY[1] * (pixelY - edgeStarts[1]->y) + stepX[1] * edgeStarts[1]->x);
+			__m128 rowWeight2 = _mm_set1_ps(stepY[2] * (pixelY - edgeStarts[2]->y) + stepX[2] * edgeStarts[2]->x);
+
+			float* row = &m_Depths[y * m_Width];
+			for (int x = xBegin; x <= triangle.m_MaxX; x += 4)
+			{
+				__m128 pixelX = _mm_add_ps(_mm_set1_ps((float)x), laneCenters);
+				__m128 weight0 = _mm_sub_ps(rowWeight0, _mm_mul_ps(stepX0, pixelX));
+				__m128 weight1 = _mm_sub_ps(rowWeight1, _mm_mul_ps(stepX1, pixelX));
+				__m128 weight2 = _mm_sub_ps(rowWeight2, _mm_mul_ps(stepX2, pixelX));
+
+				__m128 isInside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(weight0, zero), _mm_cmpge_ps(weight1, zero)), _mm_cmpge_ps(weight2, zero));
+				if (_mm_movemask_ps(isInside) == 0)
+				{
+					continue;
+				}
+
+				__m128 depth = _mm_add_ps(_mm_add_ps(_mm_mul_ps(weight0, z0), _mm_mul_ps(weight1, z1)), _mm_mul_ps(weight2, z2));
+				__m128 oldDepth = _mm_loadu_ps(row + x);
+				__m128 isCloser = _mm_and_ps(isInside, _mm_cmplt_ps(depth, oldDepth));
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(isCloser, depth), _mm_andnot_ps(isCloser, oldDepth)));
+			}
+		}
+	}
+}
+
+bool OcclusionBuffer::isVisible(const BoundingBox& worldBounds) const
+{
+	DirectX::XMFLOAT3 corners[BoundingBox::CORNER_COUNT];
+	worldBounds.GetCorners(corners);
+
+	float minX = FLT_MAX;
+	float minY = FLT_MAX;
+	float maxX = -FLT_MAX;
+	float maxY = -FLT_MAX;
+	float nearestDepth = FLT_MAX;
+	for (const DirectX::XMFLOAT3& corner : corners)
+	{
+		Vector4 projected = project(Vector3(corner.x, corner.y, corner.z), m_ViewProjection);
+		if (projected.w <= NearW)
+		{
+			// Boxes crossing the near plane surround the camera
+			return true;
+		}
+		minX = projected.x < minX ? projected.x : minX;
+		minY = projected.y < minY ? projected.y : minY;
+		maxX = projected.x > maxX ? projected.x : maxX;
+		maxY = projected.y > maxY ? projected.y : maxY;
+		nearestDepth = projected.z < nearestDepth ? projected.z : nearestDepth;
+	}
+
+	int xBegin = minX < 0.0f ? 0 : (int)minX;
+	int yBegin = minY < 0.0f ? 0 : (int)minY;
+	int xEnd = maxX >= m_Width ? m_Width - 1 : (int)maxX;
+	int yEnd = maxY >= m_Height ? m_Height - 1 : (int)maxY;
+	if (xBegin > xEnd || yBegin > yEnd || maxX < 0.0f || maxY < 0.0f)
+	{
+		// Off screen boxes are left to frustum culling
+		return true;
+	}
+
+	// Visible as soon as one covered pixel has nothing in front of the nearest point of the box
+	const __m128 laneOffsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+	const __m128 boxDepth = _mm_set1_ps(nearestDepth);
+	const __m128 firstColumn = _mm_set1_ps((float)xBegin);
+	const __m128 lastColumn = _mm_set1_ps((float)xEnd);
+	for (int y = yBegin; y <= yEnd; y++)
+	{
+		const float* row = &m_Depths[y * m_Width];
+		for (int x = xBegin & ~3; x <= xEnd; x += 4)
+		{
+			__m128 column = _mm_add_ps(_mm_set1_ps((float)x), laneOffsets);
+			__m128 isCovered = _mm_and_ps(_mm_cmpge_ps(column, firstColumn), _mm_cmple_ps(column, lastColumn));
+			__m128 isUnoccluded = _mm_cmpge_ps(_mm_loadu_ps(row + x), boxDepth);
+			if (_mm_movemask_ps(_mm_and_ps(isCovered, isUnoccluded)))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool OcclusionBuffer::saveImage(const String& path) const
+{
+	float nearest = 1.0f;
+	float farthest = 0.0f;
+	for (float depth : m_Depths)
+	{
+		if (depth < 1.0f)
+		{
+			nearest = depth < nearest ? depth : nearest;
+			farthest = depth > farthest ? depth : farthest;
+		}
+	}
+	float range = farthest > nearest ? farthest - nearest : 1.0f;
+
+	// 24 bit uncompressed bitmap, stored bottom row first with rows padded to 4 bytes
+	const unsigned int rowSize = (m_Width * 3 + 3) & ~3;
+	const unsigned int imageSize = rowSize * m_Height;
+	Vector<char> bytes;
+	bytes.reserve(54 + imageSize);
+	bytes.push_back('B');
+	bytes.push_back('M');
+	WriteLittleEndian(bytes, 54 + imageSize, 4);
+	WriteLittleEndian(bytes, 0, 4);
+	WriteLittleEndian(bytes, 54, 4);
+	WriteLittleEndian(bytes, 40, 4);
+	WriteLittleEndian(bytes, m_Width, 4);
+	WriteLittleEndian(bytes, m_Height, 4);
+	WriteLittleEndian(bytes, 1, 2);
+	WriteLittleEndian(bytes, 24, 2);
+	WriteLittleEndian(bytes, 0, 4);
+	WriteLittleEndian(bytes, imageSize, 4);
+	WriteLittleEndian(bytes, 2835, 4);
+	WriteLittleEndian(bytes, 2835, 4);
+	WriteLittleEndian(bytes, 0, 4);
+	WriteLittleEndian(bytes, 0, 4);
+
+	for (int y = m_Height - 1; y >= 0; y--)
+	{
+		for (int x = 0; x < m_Width; x++)
+		{
+			float depth = getDepth(x, y);
+			unsigned char value = depth < 1.0f ? (unsigned char)(255.0f - 200.0f * (depth - nearest) / range) : 0;
+			bytes.push_back((char)value);
+			bytes.push_back((char)value);
+			bytes.push_back((char)value);
+		}
+		for (unsigned int padding = m_Width * 3; padding < rowSize; padding++)
+		{
+			bytes.push_back(0);
+		}
+	}
+
+	InputOutputFileStream file = OS::CreateFileName(path);
+	if (!file)
+	{
+		ERR("Could not save occlusion buffer: " + path);
+		return false;
+	}
+	file.write(bytes.data(), bytes.size());
+	file.close();
+	PRINT("Saved occlusion buffer: " + path);
+	return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "common/common.h"
+
+class ThreadPool;
+class Task;
+
+/// Rows of the occlusion buffer rasterized by one task.
+#define OCCLUSION_BUFFER_BAND_HEIGHT 16
+
+/// Low resolution depth buffer filled on the CPU by rasterizing occluder triangles, used to find boxes hidden behind them.
+/// Depth is post projection z in [0, 1] with the far plane cleared to 1, as with the GPU depth buffer.
+/// Triangles crossing the near plane are skipped, which can only make occlusion less aggressive, never wrong.
+class OcclusionBuffer
+{
+	/// Occluder triangle in buffer pixel space, wound so that its area is positive.
+	struct ScreenTriangle
+	{
+		Vector3 m_Vertices[3];
+		float m_Area;
+		int m_MinX;
+		int m_MaxX;
+		int m_MinY;
+		int m_MaxY;
+	};
+
+	int m_Width;
+	int m_Height;
+	Vector<float> m_Depths;
+	Matrix m_ViewProjection;
+	Vector<ScreenTriangle> m_Triangles;
+	/// Scratch space for addOccluder(), vertices in buffer pixel space with clip space w.
+	Vector<Vector4> m_ScreenVertices;
+	Vector<Ref<Task>> m_Tasks;
+
+	/// Transforms a world space position to buffer pixel space and depth. w holds the clip space w.
+	Vector4 project(const Vector3& position, const Matrix& transform) const;
+	void rasterizeBand(int rowBegin, int rowEnd);
+
+public:
+	/// width is rounded up to a multiple of 4.
+	OcclusionBuffer(int width, int height);
+	OcclusionBuffer(OcclusionBuffer&) = delete;
+	~OcclusionBuffer() = default;
+
+	/// Clears the depths and occluders for a new frame seen through viewProjection.
+	void begin(const Matrix& viewProjection);
+	/// Queues the triangles of an occluder mesh placed at world. indices hold 3 entries per triangle.
+	void addOccluder(const Vector<Vector3>& positions, const Vector<unsigned int>& indices, const Matrix& world);
+	/// Rasterizes the queued occluders in horizontal bands spread over threadPool. Runs serially without a thread pool.
+	void rasterize(ThreadPool* threadPool);
+
+	/// Returns false if the box is entirely behind the rasterized occluders.
+	bool isVisible(const BoundingBox& worldBounds) const;
+
+	/// Writes the depths as a greyscale bitmap, nearer being brighter and empty pixels black.
+	bool saveImage(const String& path) const;
+
+	int getWidth() const { return m_Width; }
+	int getHeight() const { return m_Height; }
+	size_t getTriangleCount() const { return m_Triangles.size(); }
+	float getDepth(int x, int y) const { return m_Depths[y * m_Width + x]; }
+};
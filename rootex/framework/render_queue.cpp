@@ -0,0 +1,306 @@
+#include "render_queue.h"
+
+#include "components/visual/model_component.h"
+#include "renderer/material.h"
+#include "renderer/mesh.h"
+#include "renderer/rendering_device.h"
+
+/// Passes in the order they are drawn, indexed by the top 2 bits of the keys.
+static const RenderPass PassOrder[RENDER_QUEUE_PASS_COUNT] = { RenderPass::Editor, RenderPass::Basic, RenderPass::Alpha };
+
+static int GetPassIndex(RenderPass renderPass)
+{
+	for (int i = 0; i < RENDER_QUEUE_PASS_COUNT; i++)
+	{
+		if (PassOrder[i] == renderPass)
+		{
+			return i;
+		}
+	}
+	return 0;
+}
+
+/// Bits of a non negative float, which compare in the same order as the float.
+static unsigned int GetDepthBits(float depth)
+{
+	unsigned int bits;
+	memcpy(&bits, &depth, sizeof(bits));
+	return bits;
+}
+
+RenderQueue::RenderQueue()
+    : m_PassBatchBegin()
+{
+}
+
+unsigned int RenderQueue::getMaterialID(const Material* material)
+{
+	auto found = m_MaterialIDs.find(material);
+	if (found != m_MaterialIDs.end())
+	{
+		return found->second;
+	}
+	unsigned int id = (unsigned int)m_MaterialIDs.size();
+	m_MaterialIDs[material] = id;
+	return id;
+}
+
+unsigned int RenderQueue::getMeshID(const Mesh* mesh)
+{
+	const VertexBuffer* vertexBuffer = mesh ? mesh->m_VertexBuffer.get() : nullptr;
+	auto found = m_MeshIDs.find(vertexBuffer);
+	if (found != m_MeshIDs.end())
+	{
+		return found->second;
+	}
+	unsigned int id = (unsigned int)m_MeshIDs.size();
+	m_MeshIDs[vertexBuffer] = id;
+	return id;
+}
+
+/// True if both meshes draw the same buffers.
+static bool IsSameMesh(const Mesh* a, const Mesh* b)
+{
+	return a->m_VertexBuffer == b->m_VertexBuffer && a->m_IndexBuffer == b->m_IndexBuffer;
+}
+
+void RenderQueue::begin(const Vector3& viewPosition)
+{
+	m_ViewPosition = viewPosition;
+	m_Transforms.clear();
+	m_Packets.clear();
+	m_Keys.clear();
+	m_MaterialIDs.clear();
+	m_MeshIDs.clear();
+	m_Statistics = RenderQueueStatistics();
+}
+
+void RenderQueue::push(int passIndex, Material* material, const Mesh* mesh, ModelComponent* model, unsigned int transformIndex, float depth)
+{
+	const unsigned long long materialID = getMaterialID(material);
+	const unsigned long long meshID = getMeshID(mesh);
+	const unsigned long long depthBits = GetDepthBits(depth);
+
+	unsigned long long key = (unsigned long long)passIndex << 62;
+	if (material->isAlpha())
+	{
+		// Alpha draws blend over what is behind them, so they go back to front before sharing state.
+		// pass (2) | alpha (1) | depth back to front (30) | material (15) | mesh (16)
+		key |= 1ull << 61;
+		key |= (~(depthBits >> 1) & 0x3FFFFFFF) << 31;
+		key |= (materialID & 0x7FFF) << 16;
+		key |= meshID & 0xFFFF;
+	}
+	else
+	{
+		// pass (2) | opaque (1) | material (21) | mesh (20) | depth front to back (20)
+		key |= (materialID & 0x1FFFFF) << 40;
+		key |= (meshID & 0xFFFFF) << 20;
+		key |= (depthBits >> 11) & 0xFFFFF;
+	}
+
+	m_Packets.push_back({ material, mesh, model, transformIndex });
+	m_Keys.push_back(key);
+}
+
+void RenderQueue::submit(ModelComponent* model, const Matrix& transform)
+{
+	const unsigned int transformIndex = (unsigned int)m_Transforms.size();
+	m_Transforms.push_back(transform);
+
+	for (auto& [material, meshes] : model->getMeshes())
+	{
+		for (auto& mesh : meshes)
+		{
+			const float depth = Vector3::DistanceSquared(m_ViewPosition, Vector3::Transform(mesh.m_BoundingBox.Center, transform));
+			for (int i = 0; i < RENDER_QUEUE_PASS_COUNT; i++)
+			{
+				if (model->getRenderPass() & (unsigned int)PassOrder[i])
+				{
+					push(i, material.get(), &mesh, model, transformIndex, depth);
+				}
+			}
+		}
+	}
+}
+
+void RenderQueue::submitCustom(ModelComponent* model, Material* material, const Vector3& position)
+{
+	const float depth = Vector3::DistanceSquared(m_ViewPosition, position);
+	for (int i = 0; i < RENDER_QUEUE_PASS_COUNT; i++)
+	{
+		if (model->getRenderPass() & (unsigned int)PassOrder[i])
+		{
+			push(i, material, nullptr, model, 0, depth);
+		}
+	}
+}
+
+void RenderQueue::sort()
+{
+	const size_t count = m_Keys.size();
+	m_Order.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		m_Order[i] = (unsigned int)i;
+	}
+	m_SortedKeys.resize(count);
+	m_SortedOrder.resize(count);
+
+	for (int shift = 0; shift < 64 && count > 0; shift += 8)
+	{
+		size_t offsets[256] = {};
+		for (unsigned long long key : m_Keys)
+		{
+			offsets[(key >> shift) & 0xFF]++;
+		}
+		// Keys all sharing this byte are already in order
+		if (offsets[(m_Keys[0] >> shift) & 0xFF] == count)
+		{
+			continue;
+		}
+
+		size_t offset = 0;
+		for (size_t& bucket : offsets)
+		{
+			size_t bucketCount = bucket;
+			bucket = offset;
+			offset += bucketCount;
+		}
+		for (size_t i = 0; i < count; i++)
+		{
+			size_t& destination = offsets[(m_Keys[i] >> shift) & 0xFF];
+			m_SortedKeys[destination] = m_Keys[i];
+			m_SortedOrder[destination] = m_Order[i];
+			destination++;
+		}
+		m_Keys.swap(m_SortedKeys);
+		m_Order.swap(m_SortedOrder);
+	}
+
+	batch();
+}
+
+void RenderQueue::batch()
+{
+	m_Batches.clear();
+	m_Instances.clear();
+
+	const size_t count = m_Keys.size();
+	size_t i = 0;
+	for (int passIndex = 0; passIndex < RENDER_QUEUE_PASS_COUNT; passIndex++)
+	{
+		m_PassBatchBegin[passIndex] = m_Batches.size();
+		while (i < count && (int)(m_Keys[i] >> 62) == passIndex)
+		{
+			const DrawPacket& first = m_Packets[m_Order[i]];
+			size_t end = i + 1;
+			if (first.m_Mesh)
+			{
+				while (end < count && (int)(m_Keys[end] >> 62) == passIndex)
+				{
+					const DrawPacket& packet = m_Packets[m_Order[end]];
+					if (packet.m_Material != first.m_Material || !IsSameMesh(packet.m_Mesh, first.m_Mesh))
+					{
+						break;
+					}
+					end++;
+				}
+			}
+
+			DrawBatch batch = { i, end, false, 0 };
+			if (end - i >= RENDER_QUEUE_MIN_INSTANCES && first.m_Material->isInstanceable())
+			{
+				batch.m_IsInstanced = true;
+				batch.m_FirstInstance = (unsigned int)m_Instances.size();
+				for (size_t j = i; j < end; j++)
+				{
+					const Matrix& transform = m_Transforms[m_Packets[m_Order[j]].m_TransformIndex];
+					m_Instances.push_back({ transform, transform.Invert().Transpose(), Color(1.0f, 1.0f, 1.0f, 1.0f) });
+				}
+			}
+			m_Batches.push_back(batch);
+			i = end;
+		}
+	}
+	m_PassBatchBegin[RENDER_QUEUE_PASS_COUNT] = m_Batches.size();
+
+	m_InstanceBuffer.setData(m_Instances);
+}
+
+void RenderQueue::draw(RenderPass renderPass)
+{
+	const int passIndex = GetPassIndex(renderPass);
+
+	Material* boundMaterial = nullptr;
+	bool isBoundInstanced = false;
+	bool isInstanceBufferBound = false;
+	const Mesh* boundMesh = nullptr;
+	auto bindMesh = [&](const Mesh* mesh) {
+		if (!boundMesh || !IsSameMesh(mesh, boundMesh))
+		{
+			mesh->m_VertexBuffer->bind();
+			mesh->m_IndexBuffer->bind();
+			boundMesh = mesh;
+			m_Statistics.m_MeshBinds++;
+		}
+	};
+
+	for (size_t b = m_PassBatchBegin[passIndex]; b < m_PassBatchBegin[passIndex + 1]; b++)
+	{
+		const DrawBatch& batch = m_Batches[b];
+		const DrawPacket& first = m_Packets[m_Order[batch.m_Begin]];
+
+		if (!first.m_Mesh)
+		{
+			first.m_Model->preRender();
+			first.m_Model->render();
+			first.m_Model->postRender();
+			m_Statistics.m_Draws++;
+
+			// Models drawing themselves bind their own state
+			boundMaterial = nullptr;
+			isInstanceBufferBound = false;
+			boundMesh = nullptr;
+			continue;
+		}
+
+		if (first.m_Material != boundMaterial || batch.m_IsInstanced != isBoundInstanced)
+		{
+			if (batch.m_IsInstanced)
+			{
+				first.m_Material->bindInstancedMaterial();
+			}
+			else
+			{
+				first.m_Material->bindMaterial();
+			}
+			boundMaterial = first.m_Material;
+			isBoundInstanced = batch.m_IsInstanced;
+			m_Statistics.m_MaterialBinds++;
+		}
+
+		if (batch.m_IsInstanced)
+		{
+			if (!isInstanceBufferBound)
+			{
+				m_InstanceBuffer.bind();
+				isInstanceBufferBound = true;
+			}
+			bindMesh(first.m_Mesh);
+			RenderingDevice::GetSingleton()->drawIndexedInstanced(first.m_Mesh->m_IndexBuffer->getCount(), (unsigned int)(batch.m_End - batch.m_Begin), batch.m_FirstInstance);
+			m_Statistics.m_Draws++;
+			m_Statistics.m_Instances += batch.m_End - batch.m_Begin;
+			continue;
+		}
+
+		for (size_t i = batch.m_Begin; i < batch.m_End; i++)
+		{
+			const DrawPacket& packet = m_Packets[m_Order[i]];
+			packet.m_Material->bindTransform(m_Transforms[packet.m_TransformIndex]);
+			bindMesh(packet.m_Mesh);
+			RenderingDevice::GetSingleton()->drawIndexed(packet.m_Mesh->m_IndexBuffer->getCount());
+			m_Statistics.m_Draws++;
+		}
+	}
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "common/common.h"
+#include "renderer/render_pass.h"
+#include "renderer/instance_buffer.h"
+
+class Material;
+class VertexBuffer;
+struct Mesh;
+class ModelComponent;
+
+/// Number of render passes drawn from the queue, in the order they are drawn: Editor, Basic and Alpha.
+#define RENDER_QUEUE_PASS_COUNT 3
+/// Fewest consecutive draws of the same mesh and material that get drawn with a single instanced draw.
+#define RENDER_QUEUE_MIN_INSTANCES 2
+
+/// Counts of the last frame drawn from the render queue.
+struct RenderQueueStatistics
+{
+	/// Draw calls issued, counting an instanced draw once.
+	size_t m_Draws = 0;
+	/// Queued draws merged into instanced draws.
+	size_t m_Instances = 0;
+	size_t m_MaterialBinds = 0;
+	size_t m_MeshBinds = 0;
+};
+
+/// Collects the draws of all visible models for a frame and sorts them once, so that draws sharing state are submitted together.
+/// Each draw gets a 64 bit key made of its pass, then for opaque materials the material, mesh and depth front to back,
+/// and for alpha materials the depth back to front, then the material and mesh. Keys are sorted with an 8 bit LSD radix sort.
+/// Sorted draws of the same mesh and material are merged into one instanced draw, reading their transforms from an instance buffer.
+class RenderQueue
+{
+	/// Draw of a mesh at a transform, or of a model drawing itself when m_Mesh is null.
+	struct DrawPacket
+	{
+		Material* m_Material;
+		const Mesh* m_Mesh;
+		ModelComponent* m_Model;
+		unsigned int m_TransformIndex;
+	};
+
+	Vector3 m_ViewPosition;
+	Vector<Matrix> m_Transforms;
+	Vector<DrawPacket> m_Packets;
+	Vector<unsigned long long> m_Keys;
+	Vector<unsigned int> m_Order;
+	/// Scratch space for the radix sort.
+	Vector<unsigned long long> m_SortedKeys;
+	Vector<unsigned int> m_SortedOrder;
+
+	/// Small IDs handed out to materials and meshes in the order they are first submitted each frame.
+	/// Meshes are told apart by their vertex buffer, which models loaded from the same file share.
+	HashMap<const Material*, unsigned int> m_MaterialIDs;
+	HashMap<const VertexBuffer*, unsigned int> m_MeshIDs;
+
+	/// Consecutive sorted packets drawn together, either instanced or one after the other.
+	struct DrawBatch
+	{
+		size_t m_Begin;
+		size_t m_End;
+		bool m_IsInstanced;
+		unsigned int m_FirstInstance;
+	};
+
+	Vector<DrawBatch> m_Batches;
+	/// Batches of pass i are the ones from m_PassBatchBegin[i] up to m_PassBatchBegin[i + 1].
+	size_t m_PassBatchBegin[RENDER_QUEUE_PASS_COUNT + 1];
+	Vector<InstanceData> m_Instances;
+	InstanceBuffer m_InstanceBuffer;
+
+	RenderQueueStatistics m_Statistics;
+
+	unsigned int getMaterialID(const Material* material);
+	unsigned int getMeshID(const Mesh* mesh);
+	void push(int passIndex, Material* material, const Mesh* mesh, ModelComponent* model, unsigned int transformIndex, float depth);
+	/// Splits the sorted packets into batches and uploads the instance data of the instanced ones.
+	void batch();
+
+public:
+	RenderQueue();
+	RenderQueue(RenderQueue&) = delete;
+	~RenderQueue() = default;
+
+	/// Clears the queue for a frame seen from viewPosition.
+	void begin(const Vector3& viewPosition);
+	/// Queues every mesh of model drawn at transform, in all passes of the model.
+	void submit(ModelComponent* model, const Matrix& transform);
+	/// Queues a call to the preRender(), render() and postRender() of model in all passes of the model, for models drawing themselves.
+	/// material and position only decide where the call is sorted.
+	void submitCustom(ModelComponent* model, Material* material, const Vector3& position);
+	/// Sorts the queued draws and merges the repeated ones. Call once after all models have been submitted.
+	void sort();
+	/// Draws the sorted draws of renderPass, binding materials and meshes only when they change.
+	void draw(RenderPass renderPass);
+
+	size_t getPacketCount() const { return m_Packets.size(); }
+	const RenderQueueStatistics& getStatistics() const { return m_Statistics; }
+};
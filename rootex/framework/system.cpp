@@ -3,19 +3,36 @@
 HashMap<ComponentID, Vector<Component*>> System::s_Components;
 Map<System::UpdateOrder, Vector<System*>> System::s_Systems;
 
+const Vector<Component*>& System::GetComponents(ComponentID ID)
+{
+	static const Vector<Component*> empty;
+	auto findIt = s_Components.find(ID);
+	if (findIt == s_Components.end())
+	{
+		return empty;
+	}
+	return findIt->second;
+}
+
 void System::RegisterComponent(Component* component)
 {
-	s_Components[component->getComponentID()].push_back(component);
+	Vector<Component*>& components = s_Components[component->getComponentID()];
+	component->m_RegistryIndex = components.size();
+	component->m_IsRegistered = true;
+	components.push_back(component);
 }
 
 void System::DeregisterComponent(Component* component)
 {
 	Vector<Component*>& components = s_Components[component->getComponentID()];
 
-	auto findIt = std::find(components.begin(), components.end(), component);
-	if (findIt != components.end())
+	size_t index = component->m_RegistryIndex;
+	if (index < components.size() && components[index] == component)
 	{
-		components.erase(findIt);
+		components[index] = components.back();
+		components[index]->m_RegistryIndex = index;
+		components.pop_back();
+		component->m_IsRegistered = false;
 	}
 	else
 	{
@@ -23,9 +40,31 @@ void System::DeregisterComponent(Component* component)
 	}
 }
 
+void System::DeregisterComponents(const Function<bool(Component*)>& predicate)
+{
+	for (auto& [componentID, components] : s_Components)
+	{
+		size_t kept = 0;
+		for (Component* component : components)
+		{
+			if (!predicate(component))
+			{
+				component->m_RegistryIndex = kept;
+				components[kept++] = component;
+			}
+			else
+			{
+				component->m_IsRegistered = false;
+			}
+		}
+		components.resize(kept);
+	}
+}
+
 System::System(const String& name, const UpdateOrder& order, bool isGameplay)
     : m_SystemName(name)
     , m_UpdateOrder(order)
+    , m_IsAccessDeclared(false)
 {
 	s_Systems[order].push_back(this);
 	setActive(isGameplay);
@@ -40,6 +79,38 @@ System::~System()
 	}
 }
 
+void System::declareComponentAccess(const Vector<ComponentID>& reads, const Vector<ComponentID>& writes)
+{
+	m_ReadComponents.reset();
+	m_WriteComponents.reset();
+	for (ComponentID read : reads)
+	{
+		m_ReadComponents.set(read);
+	}
+	for (ComponentID write : writes)
+	{
+		m_WriteComponents.set(write);
+	}
+	m_IsAccessDeclared = true;
+}
+
+void System::declareExclusiveAccess()
+{
+	m_ReadComponents.set();
+	m_WriteComponents.set();
+	m_IsAccessDeclared = true;
+}
+
+bool System::isCompatibleWith(const System* other) const
+{
+	if (!m_IsAccessDeclared || !other->m_IsAccessDeclared)
+	{
+		return false;
+	}
+	return (m_WriteComponents & (other->m_ReadComponents | other->m_WriteComponents)).none()
+	    && (other->m_WriteComponents & m_ReadComponents).none();
+}
+
 bool System::initialize(const JSON::json& systemData)
 {
 	PRINT("On demand initialization skipped for: " + m_SystemName);
@@ -58,6 +129,10 @@ void System::update(float deltaMilliseconds)
 {
 }
 
+void System::sync()
+{
+}
+
 void System::end()
 {
 }
@@ -25,17 +25,33 @@ protected:
 	static HashMap<ComponentID, Vector<Component*>> s_Components;
 	static void RegisterComponent(Component* component);
 	static void DeregisterComponent(Component* component);
+	/// Deregister all components matching the predicate in a single pass over each component list.
+	static void DeregisterComponents(const Function<bool(Component*)>& predicate);
 	
 	friend class Entity;
 	friend class EntityFactory;
+	friend class EntityCommandBuffer;
 
 	String m_SystemName;
 	UpdateOrder m_UpdateOrder;
 	bool m_IsActive;
+	/// Components read and written inside update(). Only meaningful if m_IsAccessDeclared is true.
+	ComponentMask m_ReadComponents;
+	ComponentMask m_WriteComponents;
+	bool m_IsAccessDeclared;
+
+	/// Declare every component type that update() reads or writes. This allows SystemScheduler to update the system
+	/// off the main thread, concurrently with other systems that do not write what it reads and vice versa.
+	/// update() must be thread safe apart from the declared component access.
+	void declareComponentAccess(const Vector<ComponentID>& reads, const Vector<ComponentID>& writes);
+	/// Declare that update() may read and write components of every type, as systems running scripts do.
+	/// Such systems get a wave of their own, which is updated on the main thread.
+	void declareExclusiveAccess();
 
 public:
 	static const Map<UpdateOrder, Vector<System*>>& GetSystems() { return s_Systems; }
-	static const Vector<Component*>& GetComponents(ComponentID ID) { return s_Components[ID]; }
+	/// Never inserts into s_Components, so systems updated concurrently may call it. Returns an empty list for unregistered IDs.
+	static const Vector<Component*>& GetComponents(ComponentID ID);
 	
 	System(const String& name, const UpdateOrder& order, bool isGameplay);
 	System(System&) = delete;
@@ -45,11 +61,18 @@ public:
 	virtual void setConfig(const JSON::json& configData, bool openInEditor);
 	virtual void begin();
 	virtual void update(float deltaMilliseconds);
+	/// Called on the main thread once every system of the same UpdateOrder has been updated.
+	/// Lets a system apply results computed in update() to components it has not declared access to.
+	virtual void sync();
 	virtual void end();
 	
 	String getName() const { return m_SystemName; }
 	const UpdateOrder& getUpdateOrder() const { return m_UpdateOrder; }
 	bool isActive() const { return m_IsActive; }
+	/// Systems which have not declared their component access are updated alone on the main thread.
+	bool isAccessDeclared() const { return m_IsAccessDeclared; }
+	/// Returns true if neither system writes components that the other one reads or writes.
+	bool isCompatibleWith(const System* other) const;
 
 	void setActive(bool enabled);
 
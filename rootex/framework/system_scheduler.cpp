@@ -0,0 +1,102 @@
+#include "system_scheduler.h"
+
+SystemScheduler::SystemScheduler(ThreadPool& threadPool)
+    : m_ThreadPool(threadPool)
+    , m_WaveCount(0)
+{
+}
+
+void SystemScheduler::buildWaves(const Vector<System*>& systems)
+{
+	for (size_t i = 0; i < m_WaveCount; i++)
+	{
+		m_Waves[i].clear();
+	}
+	m_WaveCount = 0;
+
+	// Systems may not move ahead of an earlier system they conflict with, nor ahead of an undeclared system
+	size_t firstAvailableWave = 0;
+	for (System* system : systems)
+	{
+		if (!system->isActive())
+		{
+			continue;
+		}
+
+		size_t wave = firstAvailableWave;
+		if (system->isAccessDeclared())
+		{
+			for (size_t i = m_WaveCount; i > firstAvailableWave; i--)
+			{
+				bool isConflicting = false;
+				for (System* other : m_Waves[i - 1])
+				{
+					if (!system->isCompatibleWith(other))
+					{
+						isConflicting = true;
+						break;
+					}
+				}
+				if (isConflicting)
+				{
+					wave = i;
+					break;
+				}
+			}
+		}
+		else
+		{
+			wave = m_WaveCount;
+		}
+
+		if (wave == m_WaveCount)
+		{
+			if (m_Waves.size() == m_WaveCount)
+			{
+				m_Waves.emplace_back();
+			}
+			m_WaveCount++;
+		}
+		m_Waves[wave].push_back(system);
+
+		if (!system->isAccessDeclared())
+		{
+			firstAvailableWave = m_WaveCount;
+		}
+	}
+}
+
+void SystemScheduler::updateWave(const Vector<System*>& wave, float deltaMilliseconds)
+{
+	if (wave.size() == 1)
+	{
+		wave.front()->update(deltaMilliseconds);
+		return;
+	}
+
+	m_Tasks.clear();
+	for (System* system : wave)
+	{
+		m_Tasks.emplace_back(new Task([system, deltaMilliseconds]() { system->update(deltaMilliseconds); }));
+	}
+	m_ThreadPool.execute(m_Tasks);
+}
+
+void SystemScheduler::update(float deltaMilliseconds)
+{
+	for (auto& [order, systems] : System::GetSystems())
+	{
+		buildWaves(systems);
+		for (size_t i = 0; i < m_WaveCount; i++)
+		{
+			updateWave(m_Waves[i], deltaMilliseconds);
+		}
+		for (size_t i = 0; i < m_WaveCount; i++)
+		{
+			for (System* system : m_Waves[i])
+			{
+				system->sync();
+			}
+		}
+	}
+}
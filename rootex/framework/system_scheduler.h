@@ -0,0 +1,29 @@
+#pragma once
+
+#include "common/common.h"
+#include "system.h"
+#include "os/thread.h"
+
+/// Updates all active systems once per frame.
+/// UpdateOrder buckets are updated one after the other. Inside a bucket, systems are grouped into waves of systems
+/// with compatible component access, and each wave is updated concurrently on the ThreadPool.
+/// Systems that have not declared their component access form a wave of their own on the main thread.
+/// Once all waves of a bucket are done, System::sync() is called on each of its systems on the main thread.
+class SystemScheduler
+{
+	ThreadPool& m_ThreadPool;
+	/// Reused every frame to avoid reallocation.
+	Vector<Vector<System*>> m_Waves;
+	Vector<Ref<Task>> m_Tasks;
+	size_t m_WaveCount;
+
+	void buildWaves(const Vector<System*>& systems);
+	void updateWave(const Vector<System*>& wave, float deltaMilliseconds);
+
+public:
+	SystemScheduler(ThreadPool& threadPool);
+	SystemScheduler(SystemScheduler&) = delete;
+	~SystemScheduler() = default;
+
+	void update(float deltaMilliseconds);
+};
@@ -91,7 +91,7 @@ bool AudioSystem::initialize(const JSON::json& systemData)
 void AudioSystem::begin()
 {
 	AudioComponent* audioComponent = nullptr;
-	for (Component* component : s_Components[AudioComponent::s_ID])
+	for (Component* component : GetComponents(AudioComponent::s_ID))
 	{
 		audioComponent = (AudioComponent*)component;
 		if (audioComponent->isPlayOnStart())
@@ -104,11 +104,14 @@ void AudioSystem::begin()
 void AudioSystem::update(float deltaMilliseconds)
 {
 	AudioComponent* audioComponent = nullptr;
-	for (Component* component : s_Components[AudioComponent::s_ID])
+	for (Component* component : GetComponents(AudioComponent::s_ID))
 	{
 		audioComponent = (AudioComponent*)component;
 		audioComponent->getAudioSource()->queueNewBuffers();
-		audioComponent->update();
+	}
+	for (auto&& [audio, transform] : m_PositionedSources)
+	{
+		audio->updatePosition(transform);
 	}
 	
 	if (m_Listener)
@@ -127,7 +130,7 @@ AudioSystem* AudioSystem::GetSingleton()
 void AudioSystem::end()
 {
 	AudioComponent* audioComponent = nullptr;
-	for (Component* component : s_Components[AudioComponent::s_ID])
+	for (Component* component : GetComponents(AudioComponent::s_ID))
 	{
 		audioComponent = (AudioComponent*)component;
 		audioComponent->getAudioSource()->stop();
@@ -146,16 +149,16 @@ void AudioSystem::setConfig(const JSON::json& configData, bool openInEditor)
 		Ref<Entity> listenerEntity = EntityFactory::GetSingleton()->findEntity(configData["listener"]);
 		if (listenerEntity)
 		{
-			AudioSystem::GetSingleton()->setListener(listenerEntity->getComponent<AudioListenerComponent>().get());
+			AudioSystem::GetSingleton()->setListener(listenerEntity->getComponentPtr<AudioListenerComponent>());
 			return;
 		}
 	}
-	AudioSystem::GetSingleton()->setListener(EntityFactory::GetSingleton()->findEntity(ROOT_ENTITY_ID)->getComponent<AudioListenerComponent>().get());
+	AudioSystem::GetSingleton()->setListener(EntityFactory::GetSingleton()->findEntity(ROOT_ENTITY_ID)->getComponentPtr<AudioListenerComponent>());
 }
 
 void AudioSystem::restoreListener()
 {
-	m_Listener = EntityFactory::GetSingleton()->findEntity(ROOT_ENTITY_ID)->getComponent<AudioListenerComponent>().get();
+	m_Listener = EntityFactory::GetSingleton()->findEntity(ROOT_ENTITY_ID)->getComponentPtr<AudioListenerComponent>();
 }
 
 void AudioSystem::shutDown()
@@ -164,9 +167,10 @@ void AudioSystem::shutDown()
 }
 
 AudioSystem::AudioSystem()
-    : System("AudioSystem", UpdateOrder::Async, true)
+    : System("AudioSystem", UpdateOrder::Update, true)
 	, m_Context(nullptr)
     , m_Device(nullptr)
     , m_Listener(nullptr)
 {
+	declareComponentAccess({ TransformComponent::s_ID, AudioListenerComponent::s_ID }, { AudioComponent::s_ID });
 }
@@ -3,12 +3,14 @@
 #include "common/common.h"
 
 #include "framework/components/transform_component.h"
+#include "framework/components/audio_component.h"
 #include "framework/components/audio_listener_component.h"
 #include "vendor/OpenAL/include/al.h"
 #include "vendor/OpenAL/include/alc.h"
 #include "vendor/OpenAL/include/alut.h"
 
 #include "system.h"
+#include "entity_query.h"
 
 #ifndef ALUT_CHECK
 #ifdef _DEBUG
@@ -52,6 +54,8 @@ class AudioSystem : public System
 	ALCcontext* m_Context;
 
 	AudioListenerComponent* m_Listener;
+	/// Audio sources that can be positioned, along with their transforms.
+	EntityQuery<AudioComponent, TransformComponent> m_PositionedSources;
 
 	AudioSystem();
 	AudioSystem(AudioSystem&) = delete;
@@ -9,7 +9,7 @@ DebugSystem::DebugSystem()
 
 void DebugSystem::reportComponents()
 {
-	for (auto& component : s_Components[DebugComponent::s_ID])
+	for (DebugComponent* component : *ComponentPool<DebugComponent>::GetSingleton())
 	{
 		OS::PrintLine("Found 1 DebugComponent. EntityID: " + 
 			std::to_string(component->getOwner()->getID()) + 
@@ -1,7 +1,12 @@
 #include "hierarchy_system.h"
 
+#include "app/application.h"
+
+bool HierarchySystem::s_IsHierarchyChanged = true;
+
 HierarchySystem::HierarchySystem()
     : System("HierarchySystem", UpdateOrder::Async, false)
+    , m_TransformsVersion(0)
 {
 }
 
@@ -11,7 +16,171 @@ HierarchySystem* HierarchySystem::GetSingleton()
 	return &singleton;
 }
 
-void HierarchySystem::addChild(Ref<Entity> child)
+void HierarchySystem::addChild(Entity* child)
 {
 	m_HierarchyGraph.addChild(child);
 }
+
+void HierarchySystem::flattenHierarchy()
+{
+	m_TransformNodes.clear();
+	m_LevelOffsets.clear();
+
+	// Breadth first walk, so that every node lands after its parent and each depth is contiguous
+	Vector<HierarchyComponent*> hierarchies;
+	Vector<int> parentIndices;
+	Vector<size_t> depths;
+	hierarchies.push_back(getRootHierarchyComponent().get());
+	parentIndices.push_back(-1);
+	depths.push_back(0);
+	size_t lastDepth = -1;
+	for (size_t i = 0; i < hierarchies.size(); i++)
+	{
+		int parentIndex = parentIndices[i];
+		if (TransformComponent* transform = hierarchies[i]->getOwner()->getComponentPtr<TransformComponent>())
+		{
+			if (depths[i] != lastDepth)
+			{
+				m_LevelOffsets.push_back(m_TransformNodes.size());
+				lastDepth = depths[i];
+			}
+			parentIndex = (int)m_TransformNodes.size();
+			m_TransformNodes.push_back({ transform, parentIndices[i] });
+		}
+		for (HierarchyComponent* child : hierarchies[i]->getChildren())
+		{
+			hierarchies.push_back(child);
+			parentIndices.push_back(parentIndex);
+			depths.push_back(depths[i] + 1);
+		}
+	}
+	m_LevelOffsets.push_back(m_TransformNodes.size());
+
+	m_WorldTransforms.resize(m_TransformNodes.size());
+	m_IsNodeChanged.resize(m_TransformNodes.size());
+
+	// Children of each node, grouped by parent in the order they were flattened
+	m_ChildOffsets.assign(m_TransformNodes.size() + 1, 0);
+	for (const TransformNode& node : m_TransformNodes)
+	{
+		if (node.m_ParentIndex >= 0)
+		{
+			m_ChildOffsets[node.m_ParentIndex + 1]++;
+		}
+	}
+	for (size_t i = 0; i < m_TransformNodes.size(); i++)
+	{
+		m_ChildOffsets[i + 1] += m_ChildOffsets[i];
+	}
+	m_ChildIndices.resize(m_ChildOffsets.back());
+	Vector<size_t> childCounts(m_TransformNodes.size(), 0);
+	for (size_t i = 0; i < m_TransformNodes.size(); i++)
+	{
+		int parentIndex = m_TransformNodes[i].m_ParentIndex;
+		if (parentIndex >= 0)
+		{
+			m_ChildIndices[m_ChildOffsets[parentIndex] + childCounts[parentIndex]++] = i;
+		}
+	}
+}
+
+void HierarchySystem::updateTransformRange(size_t begin, size_t end, bool isRebuilt, ComponentVersion version)
+{
+	for (size_t i = begin; i < end; i++)
+	{
+		const TransformNode& node = m_TransformNodes[i];
+		bool isParentChanged = node.m_ParentIndex >= 0 && m_IsNodeChanged[node.m_ParentIndex];
+		if (isParentChanged)
+		{
+			node.m_Transform->setParentAbsoluteTransform(m_WorldTransforms[node.m_ParentIndex], version);
+		}
+
+		bool isChanged = isRebuilt || isParentChanged || node.m_Transform->hasChangedSince(m_TransformsVersion);
+		m_IsNodeChanged[i] = isChanged;
+		if (isChanged)
+		{
+			node.m_Transform->cacheAbsoluteTransform();
+			m_WorldTransforms[i] = node.m_Transform->m_AbsoluteTransform;
+		}
+	}
+}
+
+void HierarchySystem::updateHierarchyBounds()
+{
+	// Children are stored after their parents, so walking backwards finishes every child before its parent
+	for (size_t i = m_TransformNodes.size(); i-- > 0;)
+	{
+		bool isChanged = m_IsNodeChanged[i];
+		for (size_t c = m_ChildOffsets[i]; c < m_ChildOffsets[i + 1] && !isChanged; c++)
+		{
+			isChanged = m_IsNodeChanged[m_ChildIndices[c]];
+		}
+		if (!isChanged)
+		{
+			continue;
+		}
+		m_IsNodeChanged[i] = true;
+
+		TransformComponent* transform = m_TransformNodes[i].m_Transform;
+		bool hasBounds = transform->m_IsBoundsFitted;
+		BoundingBox bounds = hasBounds ? transform->getWorldBounds() : BoundingBox();
+		for (size_t c = m_ChildOffsets[i]; c < m_ChildOffsets[i + 1]; c++)
+		{
+			const TransformComponent* child = m_TransformNodes[m_ChildIndices[c]].m_Transform;
+			if (!child->m_HasHierarchyBounds)
+			{
+				continue;
+			}
+			if (hasBounds)
+			{
+				BoundingBox::CreateMerged(bounds, bounds, child->m_HierarchyBounds);
+			}
+			else
+			{
+				bounds = child->m_HierarchyBounds;
+				hasBounds = true;
+			}
+		}
+		transform->m_HierarchyBounds = bounds;
+		transform->m_HasHierarchyBounds = hasBounds;
+	}
+}
+
+void HierarchySystem::updateTransforms()
+{
+	bool isRebuilt = s_IsHierarchyChanged;
+	if (isRebuilt)
+	{
+		flattenHierarchy();
+		s_IsHierarchyChanged = false;
+	}
+
+	// Every transform moved by its parent in this pass shares one version, so that worker threads do not contend on the counter
+	const ComponentVersion version = Component::NewChangeVersion();
+	ThreadPool& threadPool = Application::GetSingleton()->getThreadPool();
+	for (size_t level = 0; level + 1 < m_LevelOffsets.size(); level++)
+	{
+		size_t begin = m_LevelOffsets[level];
+		size_t end = m_LevelOffsets[level + 1];
+		if (end - begin < 2 * HIERARCHY_TRANSFORM_BATCH_SIZE || threadPool.getThreadCount() == 0)
+		{
+			updateTransformRange(begin, end, isRebuilt, version);
+			continue;
+		}
+
+		m_Tasks.clear();
+		for (size_t batchBegin = begin; batchBegin < end; batchBegin += HIERARCHY_TRANSFORM_BATCH_SIZE)
+		{
+			size_t batchEnd = batchBegin + HIERARCHY_TRANSFORM_BATCH_SIZE;
+			if (batchEnd > end)
+			{
+				batchEnd = end;
+			}
+			m_Tasks.emplace_back(new Task([this, batchBegin, batchEnd, isRebuilt, version]() { updateTransformRange(batchBegin, batchEnd, isRebuilt, version); }));
+		}
+		threadPool.execute(m_Tasks);
+	}
+
+	updateHierarchyBounds();
+	m_TransformsVersion = Component::GetCurrentChangeVersion();
+}
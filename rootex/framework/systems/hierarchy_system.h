@@ -3,19 +3,65 @@
 #include "framework/system.h"
 #include "components/hierarchy_component.h"
 #include "components/hierarchy_graph.h"
+#include "components/transform_component.h"
+#include "os/thread.h"
+
+/// Depth levels of the flattened hierarchy with at least twice this many nodes are split into batches of this size and updated on the thread pool.
+#define HIERARCHY_TRANSFORM_BATCH_SIZE 2048
 
 /// Generates hierarchy system out of hierarchy graph, entities and components.
 class HierarchySystem : public System
 {
+public:
+	/// Entry of the flattened hierarchy. Parents are always stored before their children.
+	struct TransformNode
+	{
+		TransformComponent* m_Transform;
+		/// Position of the parent node in m_TransformNodes. Negative for the root.
+		int m_ParentIndex;
+	};
+
+private:
+	static bool s_IsHierarchyChanged;
+
 	HierarchyGraph m_HierarchyGraph;
 
+	Vector<TransformNode> m_TransformNodes;
+	/// Start of each depth level in m_TransformNodes, followed by the node count. Nodes in one level never depend on each other.
+	Vector<size_t> m_LevelOffsets;
+	/// World transforms of m_TransformNodes, at the same positions.
+	Vector<Matrix> m_WorldTransforms;
+	/// Children of node i are m_ChildIndices[m_ChildOffsets[i]] up to m_ChildIndices[m_ChildOffsets[i + 1]].
+	Vector<size_t> m_ChildOffsets;
+	Vector<size_t> m_ChildIndices;
+	/// Scratch space for updateTransforms(), marks nodes whose world transform, and later whose hierarchy bounds, changed this pass.
+	Vector<char> m_IsNodeChanged;
+	/// Change version at the end of the last updateTransforms() pass.
+	ComponentVersion m_TransformsVersion;
+	Vector<Ref<Task>> m_Tasks;
+
 	HierarchySystem();
 
+	void flattenHierarchy();
+	/// Transforms moved by their parent are stamped with version.
+	void updateTransformRange(size_t begin, size_t end, bool isRebuilt, ComponentVersion version);
+	/// Merges fitted world bounds bottom up into the hierarchy bounds of every ancestor of a changed node, in one backward walk.
+	void updateHierarchyBounds();
+
 public:
 	static HierarchySystem* GetSingleton();
 
+	/// Requests a rebuild of the flattened hierarchy before the next transform update. Call whenever parenting changes.
+	static void InvalidateHierarchy() { s_IsHierarchyChanged = true; }
+
+	/// Recomputes world transforms and bounds of the subtrees that moved since the last call, one depth level at a time.
+	/// Large levels are spread over the thread pool. Each node is computed exactly as in a serial pass, so results do not depend on the thread count.
+	void updateTransforms();
+	/// Transforms in the order of the last updateTransforms(), breadth first from the root.
+	const Vector<TransformNode>& getTransformNodes() const { return m_TransformNodes; }
+
 	/// Adds child entity to root hierarchy component of hierarchy graph.
-	void addChild(Ref<Entity> child);
+	void addChild(Entity* child);
 
 	/// Points to Root Entity of hierarchy graph.
 	Ref<Entity> getRootEntity() const { return m_HierarchyGraph.getRootEntity(); }
@@ -2,8 +2,9 @@
 #include "core/renderer/shaders/register_locations_pixel_shader.h"
 
 LightSystem::LightSystem()
-    : System("LightSystem", UpdateOrder::Async, false)
+    : System("LightSystem", UpdateOrder::Update, true)
 {
+	declareComponentAccess({ PointLightComponent::s_ID, SpotLightComponent::s_ID, DirectionalLightComponent::s_ID, TransformComponent::s_ID, CameraComponent::s_ID }, {});
 }
 
 LightSystem* LightSystem::GetSingleton()
@@ -12,29 +13,30 @@ LightSystem* LightSystem::GetSingleton()
 	return &singleton;
 }
 
-LightsInfo LightSystem::getLights()
+void LightSystem::update(float deltaMilliseconds)
 {
-	Vector<Component*> pointLightComponents = s_Components[PointLightComponent::s_ID];
-
-	LightsInfo lights;
+	LightsInfo& lights = m_Lights;
+	lights = LightsInfo();
 
 	Vector3 cameraPos = RenderSystem::GetSingleton()->getCamera()->getAbsolutePosition();
 	lights.cameraPos = cameraPos;
 
-	static auto sortingLambda = [&cameraPos](const Component* a, const Component* b) -> bool {
-		Vector3& aa = a->getOwner()->getComponent<TransformComponent>()->getAbsoluteTransform().Translation();
-		Vector3& bb = b->getOwner()->getComponent<TransformComponent>()->getAbsoluteTransform().Translation();
+	auto sortingLambda = [&cameraPos](const auto& a, const auto& b) -> bool {
+		const Vector3& aa = std::get<TransformComponent*>(a)->getAbsolutePosition();
+		const Vector3& bb = std::get<TransformComponent*>(b)->getAbsolutePosition();
 		return Vector3::DistanceSquared(cameraPos, aa) < Vector3::DistanceSquared(cameraPos, bb);
 	};
 
-	sort(pointLightComponents.begin(), pointLightComponents.end(), sortingLambda);
+	const auto& pointLightMatches = m_PointLights.getMatches();
+	Vector<EntityQuery<PointLightComponent, TransformComponent>::Match>& pointLights = m_SortedPointLights;
+	pointLights.assign(pointLightMatches.begin(), pointLightMatches.end());
+	sort(pointLights.begin(), pointLights.end(), sortingLambda);
 
 	int i = 0;
-	for (; i < pointLightComponents.size() && i < MAX_POINT_LIGHTS; i++)
+	for (; i < pointLights.size() && i < MAX_POINT_LIGHTS; i++)
 	{
-		PointLightComponent* light = dynamic_cast<PointLightComponent*>(pointLightComponents[i]);
-		TransformComponent* transform = light->getOwner()->getComponent<TransformComponent>().get();
-		Vector3 transformedPosition = transform->getAbsoluteTransform().Translation();
+		auto&& [light, transform] = pointLights[i];
+		Vector3 transformedPosition = transform->getAbsolutePosition();
 		lights.pointLightInfos[i] = {
 			light->m_AmbientColor, light->m_DiffuseColor, light->m_DiffuseIntensity,
 			light->m_AttConst, light->m_AttLin, light->m_AttQuad,
@@ -43,7 +45,7 @@ LightsInfo LightSystem::getLights()
 	}
 	lights.pointLightCount = i;
 
-	const Vector<Component*>& directionalLightComponents = s_Components[DirectionalLightComponent::s_ID];
+	const Vector<Component*>& directionalLightComponents = GetComponents(DirectionalLightComponent::s_ID);
 
 	if (directionalLightComponents.size() > 1)
 	{
@@ -52,7 +54,7 @@ LightsInfo LightSystem::getLights()
 
 	if (directionalLightComponents.size() > 0)
 	{
-		DirectionalLightComponent* light = dynamic_cast<DirectionalLightComponent*>(directionalLightComponents[0]);
+		DirectionalLightComponent* light = static_cast<DirectionalLightComponent*>(directionalLightComponents[0]);
 
 		lights.directionalLightInfo = {
 			light->m_Direction, light->m_DiffuseIntensity, light->m_DiffuseColor,
@@ -61,15 +63,16 @@ LightsInfo LightSystem::getLights()
 		lights.directionalLightPresent = 1;
 	}
 
-	Vector<Component*>& spotLightComponents = s_Components[SpotLightComponent::s_ID];
-
-	sort(spotLightComponents.begin(), spotLightComponents.end(), sortingLambda);
+	const auto& spotLightMatches = m_SpotLights.getMatches();
+	Vector<EntityQuery<SpotLightComponent, TransformComponent>::Match>& spotLights = m_SortedSpotLights;
+	spotLights.assign(spotLightMatches.begin(), spotLightMatches.end());
+	sort(spotLights.begin(), spotLights.end(), sortingLambda);
 
 	i = 0;
-	for (; i < spotLightComponents.size() && i < MAX_SPOT_LIGHTS; i++)
+	for (; i < spotLights.size() && i < MAX_SPOT_LIGHTS; i++)
 	{
-		SpotLightComponent* light = dynamic_cast<SpotLightComponent*>(spotLightComponents[i]);
-		Matrix transform = light->getOwner()->getComponent<TransformComponent>()->getAbsoluteTransform();
+		SpotLightComponent* light = std::get<SpotLightComponent*>(spotLights[i]);
+		Matrix transform = std::get<TransformComponent*>(spotLights[i])->getAbsoluteTransform();
 		lights.spotLightInfos[i] = {
 			light->m_AmbientColor, light->m_DiffuseColor, light->m_DiffuseIntensity,
 			light->m_AttConst, light->m_AttLin, light->m_AttQuad,
@@ -78,6 +81,4 @@ LightsInfo LightSystem::getLights()
 		};
 	}
 	lights.spotLightCount = i;
-
-	return lights;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "system.h"
+#include "entity_query.h"
 #include "renderer/constant_buffer.h"
 #include "components/visual/point_light_component.h"
 #include "components/visual/directional_light_component.h"
@@ -9,12 +10,23 @@
 #include "framework/systems/render_system.h"
 
 /// Interface for setting up point, directional and spot lights.
+/// Lights nearest to the camera are gathered in update(), alongside other systems, and read back by the RenderSystem.
 class LightSystem : public System
 {
+	EntityQuery<PointLightComponent, TransformComponent> m_PointLights;
+	EntityQuery<SpotLightComponent, TransformComponent> m_SpotLights;
+	LightsInfo m_Lights;
+	/// Scratch space for update(), sorted by distance to the camera. Kept to reuse its storage every frame.
+	Vector<EntityQuery<PointLightComponent, TransformComponent>::Match> m_SortedPointLights;
+	Vector<EntityQuery<SpotLightComponent, TransformComponent>::Match> m_SortedSpotLights;
+
 	LightSystem();
 
 public:
 	static LightSystem* GetSingleton();
 
-	LightsInfo getLights();
+	void update(float deltaMilliseconds) override;
+
+	/// Lights gathered in the last update().
+	const LightsInfo& getLights() const { return m_Lights; }
 };
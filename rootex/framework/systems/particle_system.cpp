@@ -0,0 +1,116 @@
+#include "particle_system.h"
+
+#include "app/application.h"
+
+ParticleSystem::ParticleSystem()
+    : System("ParticleSystem", UpdateOrder::Async, false)
+{
+}
+
+ParticleSystem* ParticleSystem::GetSingleton()
+{
+	static ParticleSystem singleton;
+	return &singleton;
+}
+
+void ParticleSystem::simulateRanges(size_t begin, size_t end, float deltaSeconds)
+{
+	for (size_t i = begin; i < end; i++)
+	{
+		const ParticleRange& range = m_Ranges[i];
+		range.m_Emitter->simulate(range.m_Begin, range.m_End, deltaSeconds);
+	}
+}
+
+void ParticleSystem::update(float deltaMilliseconds)
+{
+	m_Statistics = ParticleStatistics();
+	const float deltaSeconds = deltaMilliseconds * MS_TO_S;
+
+	m_Emitters.clear();
+	for (CPUParticlesComponent* particles : *ComponentPool<CPUParticlesComponent>::GetSingleton())
+	{
+		particles->emitParticles();
+		if (particles->getAliveCount())
+		{
+			m_Emitters.push_back(particles);
+		}
+		m_Statistics.m_Emitters++;
+	}
+
+	m_Ranges.clear();
+	size_t particleCount = 0;
+	for (CPUParticlesComponent* particles : m_Emitters)
+	{
+		const size_t simulatedCount = particles->getSimulatedCount();
+		for (size_t begin = 0; begin < simulatedCount; begin += PARTICLE_SYSTEM_CHUNK_SIZE)
+		{
+			size_t end = begin + PARTICLE_SYSTEM_CHUNK_SIZE;
+			if (end > simulatedCount)
+			{
+				end = simulatedCount;
+			}
+			m_Ranges.push_back({ particles, begin, end });
+		}
+		particleCount += simulatedCount;
+	}
+
+	ThreadPool& threadPool = Application::GetSingleton()->getThreadPool();
+	if (particleCount < 2 * PARTICLE_SYSTEM_CHUNK_SIZE || threadPool.getThreadCount() == 0)
+	{
+		simulateRanges(0, m_Ranges.size(), deltaSeconds);
+	}
+	else
+	{
+		// Consecutive ranges are packed into tasks of at least a chunk of particles each
+		m_Tasks.clear();
+		size_t taskBegin = 0;
+		size_t taskParticles = 0;
+		for (size_t i = 0; i < m_Ranges.size(); i++)
+		{
+			taskParticles += m_Ranges[i].m_End - m_Ranges[i].m_Begin;
+			if (taskParticles >= PARTICLE_SYSTEM_CHUNK_SIZE || i + 1 == m_Ranges.size())
+			{
+				size_t taskEnd = i + 1;
+				m_Tasks.emplace_back(new Task([this, taskBegin, taskEnd, deltaSeconds]() { simulateRanges(taskBegin, taskEnd, deltaSeconds); }));
+				taskBegin = taskEnd;
+				taskParticles = 0;
+			}
+		}
+		threadPool.execute(m_Tasks);
+		m_Statistics.m_Tasks = m_Tasks.size();
+	}
+
+	for (CPUParticlesComponent* particles : m_Emitters)
+	{
+		particles->removeDead();
+		m_Statistics.m_Alive += particles->getAliveCount();
+	}
+}
+
+#ifdef ROOTEX_EDITOR
+#include "imgui.h"
+void ParticleSystem::draw()
+{
+	System::draw();
+
+	ImGui::Columns(2);
+
+	ImGui::Text("Emitters");
+	ImGui::NextColumn();
+	ImGui::Text("%d", (int)m_Statistics.m_Emitters);
+	ImGui::NextColumn();
+
+	ImGui::Text("Alive");
+	ImGui::NextColumn();
+	ImGui::Text("%d", (int)m_Statistics.m_Alive);
+	ImGui::NextColumn();
+
+	ImGui::Text("Tasks");
+	ImGui::NextColumn();
+	ImGui::Text("%d", (int)m_Statistics.m_Tasks);
+	ImGui::NextColumn();
+
+	ImGui::Columns(1);
+}
+#endif // ROOTEX_EDITOR
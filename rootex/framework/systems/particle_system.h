@@ -0,0 +1,58 @@
+#pragma once
+
+#include "framework/system.h"
+#include "components/visual/cpu_particles_component.h"
+#include "os/thread.h"
+
+/// Particles simulated by one task. Emitters with more live particles are split into several tasks,
+/// and emitters with fewer are packed together into one. Must be a multiple of 4.
+#define PARTICLE_SYSTEM_CHUNK_SIZE 4096
+
+/// Counts of the last particle update.
+struct ParticleStatistics
+{
+	size_t m_Emitters = 0;
+	/// Live particles after the update.
+	size_t m_Alive = 0;
+	/// Tasks the simulation was split into. 0 if it ran on the calling thread.
+	size_t m_Tasks = 0;
+};
+
+/// Updates every CPUParticlesComponent once per frame, before the render passes.
+/// Emission runs first on the calling thread, emitter by emitter, with each emitter drawing from its own random sequence.
+/// Live particles are then simulated on the thread pool in chunks of PARTICLE_SYSTEM_CHUNK_SIZE, which also writes their instance data, and dead particles are removed
+/// on the calling thread. Each particle is simulated exactly as in a serial pass, so results do not depend on the thread count.
+class ParticleSystem : public System
+{
+	/// Part of the live particles of an emitter, starting at a multiple of 4.
+	struct ParticleRange
+	{
+		CPUParticlesComponent* m_Emitter;
+		size_t m_Begin;
+		size_t m_End;
+	};
+
+	Vector<CPUParticlesComponent*> m_Emitters;
+	Vector<ParticleRange> m_Ranges;
+	Vector<Ref<Task>> m_Tasks;
+
+	ParticleStatistics m_Statistics;
+
+	ParticleSystem();
+	ParticleSystem(ParticleSystem&) = delete;
+	virtual ~ParticleSystem() = default;
+
+	void simulateRanges(size_t begin, size_t end, float deltaSeconds);
+
+public:
+	static ParticleSystem* GetSingleton();
+
+	/// Emits, moves and ages the particles of every emitter. Call after HierarchySystem::updateTransforms().
+	void update(float deltaMilliseconds) override;
+
+	const ParticleStatistics& getStatistics() const { return m_Statistics; }
+
+#ifdef ROOTEX_EDITOR
+	void draw() override;
+#endif // ROOTEX_EDITOR
+};
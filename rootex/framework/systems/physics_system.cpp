@@ -21,6 +21,8 @@ PhysicsSystem* PhysicsSystem::GetSingleton()
 PhysicsSystem::PhysicsSystem()
     : System("PhysicsSystem", UpdateOrder::Update, true)
 {
+	// Collisions call into scripts
+	declareExclusiveAccess();
 }
 
 bool PhysicsSystem::initialize(const JSON::json& systemData)
@@ -125,7 +127,7 @@ void PhysicsSystem::debugDraw()
 	RenderSystem::GetSingleton()->getRenderer()->bind(m_DebugDrawer.getMaterial());
 
 	RenderSystem::GetSingleton()->enableLineRenderMode();
-	for (auto& component : s_Components[PhysicsColliderComponent::s_ID])
+	for (auto& component : GetComponents(PhysicsColliderComponent::s_ID))
 	{
 		PhysicsColliderComponent* p = (PhysicsColliderComponent*)component;
 		p->render();
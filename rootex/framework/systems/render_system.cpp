@@ -4,6 +4,9 @@
 #include "renderer/shaders/register_locations_vertex_shader.h"
 #include "renderer/shaders/register_locations_pixel_shader.h"
 #include "light_system.h"
+#include "spatial_system.h"
+#include "visibility_system.h"
+#include "particle_system.h"
 #include "renderer/material_library.h"
 #include "components/visual/sky_component.h"
 #include "application.h"
@@ -22,7 +25,7 @@ RenderSystem::RenderSystem()
     , m_PSPerFrameConstantBuffer(nullptr)
     , m_IsEditorRenderPassEnabled(false)
 {
-	m_Camera = HierarchySystem::GetSingleton()->getRootEntity()->getComponent<CameraComponent>().get();
+	m_Camera = HierarchySystem::GetSingleton()->getRootEntity()->getComponentPtr<CameraComponent>();
 	m_TransformationStack.push_back(Matrix::Identity);
 	setProjectionConstantBuffers();
 	
@@ -31,33 +34,24 @@ RenderSystem::RenderSystem()
 	m_CurrentFrameLines.m_Indices.reserve(LINE_INITIAL_RENDER_CACHE * 2);
 }
 
-void RenderSystem::calculateTransforms(HierarchyComponent* hierarchyComponent)
-{
-	pushMatrix(hierarchyComponent->getOwner()->getComponent<TransformComponent>()->getLocalTransform());
-	for (auto&& child : hierarchyComponent->getChildren())
-	{
-		child->getOwner()->getComponent<TransformComponent>()->m_ParentAbsoluteTransform = getCurrentMatrix();
-		calculateTransforms(child);
-	}
-	popMatrix();
-}
-
-void RenderSystem::renderPassRender(RenderPass renderPass)
+void RenderSystem::fillRenderQueue()
 {
+	m_RenderQueue.begin(m_Camera->getOwner()->getComponentPtr<TransformComponent>()->getAbsolutePosition());
 	ModelComponent* mc = nullptr;
-	for (auto& component : s_Components[ModelComponent::s_ID])
+	for (auto& component : GetComponents(ModelComponent::s_ID))
 	{
 		mc = (ModelComponent*)component;
-		if (mc->getRenderPass() & (unsigned int)renderPass)
+		if (mc->isVisible() && !mc->isCulled())
 		{
-			mc->preRender();
-			if (mc->isVisible())
-			{
-				mc->render();
-			}
-			mc->postRender();
+			mc->submit(m_RenderQueue);
 		}
 	}
+	m_RenderQueue.sort();
+}
+
+void RenderSystem::renderPassRender(RenderPass renderPass)
+{
+	m_RenderQueue.draw(renderPass);
 }
 
 void RenderSystem::recoverLostDevice()
@@ -72,11 +66,11 @@ void RenderSystem::setConfig(const JSON::json& configData, bool openInEditor)
 		Ref<Entity> cameraEntity = EntityFactory::GetSingleton()->findEntity(configData["camera"]);
 		if (cameraEntity)
 		{
-			setCamera(cameraEntity->getComponent<CameraComponent>().get());
+			setCamera(cameraEntity->getComponentPtr<CameraComponent>());
 			return;
 		}
 	}
-	setCamera(EntityFactory::GetSingleton()->findEntity(ROOT_ENTITY_ID)->getComponent<CameraComponent>().get());
+	setCamera(EntityFactory::GetSingleton()->findEntity(ROOT_ENTITY_ID)->getComponentPtr<CameraComponent>());
 }
 
 void RenderSystem::update(float deltaMilliseconds)
@@ -85,14 +79,13 @@ void RenderSystem::update(float deltaMilliseconds)
 	float fogStart = 0.0f;
 	float fogEnd = -1000.0f;
 
-	if (!s_Components[FogComponent::s_ID].empty())
+	ComponentPool<FogComponent>* fogs = ComponentPool<FogComponent>::GetSingleton();
+	if (fogs->begin() != fogs->end())
 	{
-		FogComponent* firstFog = (FogComponent*)s_Components[FogComponent::s_ID].front();
-		clearColor = firstFog->getColor();
+		clearColor = (*fogs->begin())->getColor();
 
-		for (auto& component : s_Components[FogComponent::s_ID])
+		for (FogComponent* fog : *fogs)
 		{
-			FogComponent* fog = (FogComponent*)component;
 			clearColor = Color::Lerp(clearColor, fog->getColor(), 0.5f);
 			fogStart = fog->getNearDistance();
 			fogEnd = fog->getFarDistance();
@@ -100,8 +93,11 @@ void RenderSystem::update(float deltaMilliseconds)
 	}
 	Application::GetSingleton()->getWindow()->clearCurrentTarget(clearColor);
 
-	Ref<HierarchyComponent> rootHC = HierarchySystem::GetSingleton()->getRootEntity()->getComponent<HierarchyComponent>();
-	calculateTransforms(rootHC.get());
+	HierarchySystem::GetSingleton()->updateTransforms();
+	SpatialSystem::GetSingleton()->updateBounds();
+	ParticleSystem::GetSingleton()->update(deltaMilliseconds);
+	VisibilitySystem::GetSingleton()->cull(m_Camera->getViewMatrix() * m_Camera->getProjectionMatrix());
+	fillRenderQueue();
 
 	RenderingDevice::GetSingleton()->setPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 	RenderingDevice::GetSingleton()->setCurrentRasterizerState();
@@ -126,9 +122,8 @@ void RenderSystem::update(float deltaMilliseconds)
 		RenderingDevice::RasterizerState currentRS = RenderingDevice::GetSingleton()->getRasterizerState();
 		RenderingDevice::GetSingleton()->setRasterizerState(RenderingDevice::RasterizerState::Sky);
 		RenderingDevice::GetSingleton()->setCurrentRasterizerState();
-		for (auto& component : s_Components[SkyComponent::s_ID])
+		for (SkyComponent* sky : *ComponentPool<SkyComponent>::GetSingleton())
 		{
-			SkyComponent* sky = (SkyComponent*)component;
 			for (auto& [material, meshes] : sky->getSkySphere()->getMeshes())
 			{
 				m_Renderer->bind(sky->getSkyMaterial());
@@ -243,7 +238,7 @@ void RenderSystem::setCamera(CameraComponent* camera)
 
 void RenderSystem::restoreCamera()
 {
-	setCamera(HierarchySystem::GetSingleton()->getRootEntity()->getComponent<CameraComponent>().get());
+	setCamera(HierarchySystem::GetSingleton()->getRootEntity()->getComponentPtr<CameraComponent>());
 }
 
 const Matrix& RenderSystem::getCurrentMatrix() const
@@ -273,6 +268,28 @@ void RenderSystem::draw()
 
 		ImGui::EndCombo();
 	}
+	ImGui::NextColumn();
+
+	const RenderQueueStatistics& statistics = m_RenderQueue.getStatistics();
+	ImGui::Text("Draws");
+	ImGui::NextColumn();
+	ImGui::Text("%d", (int)statistics.m_Draws);
+	ImGui::NextColumn();
+
+	ImGui::Text("Instances");
+	ImGui::NextColumn();
+	ImGui::Text("%d", (int)statistics.m_Instances);
+	ImGui::NextColumn();
+
+	ImGui::Text("Material Binds");
+	ImGui::NextColumn();
+	ImGui::Text("%d", (int)statistics.m_MaterialBinds);
+	ImGui::NextColumn();
+
+	ImGui::Text("Mesh Binds");
+	ImGui::NextColumn();
+	ImGui::Text("%d", (int)statistics.m_MeshBinds);
+	ImGui::NextColumn();
 
 	ImGui::Columns(1);
 }
@@ -3,6 +3,7 @@
 #include "core/renderer/renderer.h"
 #include "framework/components/visual/camera_component.h"
 #include "framework/system.h"
+#include "framework/render_queue.h"
 #include "framework/systems/hierarchy_system.h"
 #include "main/window.h"
 #include "components/visual/model_component.h"
@@ -21,6 +22,7 @@ class RenderSystem : public System
 	CameraComponent* m_Camera;
 
 	Ptr<Renderer> m_Renderer;
+	RenderQueue m_RenderQueue;
 	Vector<Matrix> m_TransformationStack;
 
 	Ref<BasicMaterial> m_LineMaterial;
@@ -36,6 +38,8 @@ class RenderSystem : public System
 	RenderSystem(RenderSystem&) = delete;
 	virtual ~RenderSystem() = default;
 
+	/// Queues the draws of all visible models and sorts them for the passes of this frame.
+	void fillRenderQueue();
 	void renderPassRender(RenderPass renderPass);
 
 public:
@@ -50,7 +54,6 @@ public:
 	void setCamera(CameraComponent* camera);
 	void restoreCamera();
 
-	void calculateTransforms(HierarchyComponent* hierarchyComponent);
 	void pushMatrix(const Matrix& transform);
 	void pushMatrixOverride(const Matrix& transform);
 	void popMatrix();
@@ -70,6 +73,7 @@ public:
 	CameraComponent* getCamera() const { return m_Camera; }
 	const Matrix& getCurrentMatrix() const;
 	const Renderer* getRenderer() const { return m_Renderer.get(); }
+	const RenderQueue& getRenderQueue() const { return m_RenderQueue; }
 
 #ifdef ROOTEX_EDITOR
 	void draw() override;
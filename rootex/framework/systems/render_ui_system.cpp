@@ -20,7 +20,7 @@ void RenderUISystem::update(float deltaMilliseconds)
 {
 	RenderingDevice::GetSingleton()->beginDrawUI();
 	RenderUIComponent* ui = nullptr;
-	for (auto& component : s_Components[RenderUIComponent::s_ID])
+	for (auto& component : GetComponents(RenderUIComponent::s_ID))
 	{
 		ui = (RenderUIComponent*)component;
 		if (ui->isVisible())
@@ -5,6 +5,7 @@
 ScriptSystem::ScriptSystem()
     : System("ScriptSystem", UpdateOrder::Update, true)
 {
+	declareExclusiveAccess();
 }
 
 ScriptSystem* ScriptSystem::GetSingleton()
@@ -15,30 +16,24 @@ ScriptSystem* ScriptSystem::GetSingleton()
 
 void ScriptSystem::begin()
 {
-	ScriptComponent* scriptComponent = nullptr;
-	for (auto&& component : s_Components[ScriptComponent::s_ID])
+	for (ScriptComponent* scriptComponent : *ComponentPool<ScriptComponent>::GetSingleton())
 	{
-		scriptComponent = (ScriptComponent*)component;
 		scriptComponent->onBegin();
 	}
 }
 
 void ScriptSystem::update(float deltaMilliseconds)
 {
-	ScriptComponent* scriptComponent = nullptr;
-	for (auto&& component : s_Components[ScriptComponent::s_ID])
+	for (ScriptComponent* scriptComponent : *ComponentPool<ScriptComponent>::GetSingleton())
 	{
-		scriptComponent = (ScriptComponent*)component;
 		scriptComponent->onUpdate(deltaMilliseconds);
 	}
 }
 
 void ScriptSystem::end()
 {
-	ScriptComponent* scriptComponent = nullptr;
-	for (auto&& component : s_Components[ScriptComponent::s_ID])
+	for (ScriptComponent* scriptComponent : *ComponentPool<ScriptComponent>::GetSingleton())
 	{
-		scriptComponent = (ScriptComponent*)component;
 		scriptComponent->onEnd();
 	}
 }
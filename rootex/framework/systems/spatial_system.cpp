@@ -0,0 +1,125 @@
+#include "spatial_system.h"
+
+#include "render_system.h"
+
+SpatialSystem::SpatialSystem()
+    : System("SpatialSystem", UpdateOrder::Async, false)
+    , m_BoundsVersion(0)
+{
+}
+
+SpatialSystem::~SpatialSystem()
+{
+	// Transforms released during static destruction must not reach back into a destroyed tree
+	for (TransformComponent* transform : *ComponentPool<TransformComponent>::GetSingleton())
+	{
+		transform->m_SpatialProxy = -1;
+	}
+}
+
+void SpatialSystem::RegisterAPI(sol::table& rootex)
+{
+	sol::usertype<SpatialSystem> spatialSystem = rootex.new_usertype<SpatialSystem>("SpatialSystem");
+	spatialSystem["QueryBox"] = [](const Vector3& center, const Vector3& extents) { return sol::as_table(SpatialSystem::GetSingleton()->queryBox(BoundingBox(center, extents))); };
+	spatialSystem["QuerySphere"] = [](const Vector3& center, float radius) { return sol::as_table(SpatialSystem::GetSingleton()->querySphere(center, radius)); };
+	spatialSystem["QueryFrustum"] = [](const Matrix& viewProjection) { return sol::as_table(SpatialSystem::GetSingleton()->queryFrustum(viewProjection)); };
+	spatialSystem["QueryCameraFrustum"] = []() {
+		CameraComponent* camera = RenderSystem::GetSingleton()->getCamera();
+		return sol::as_table(SpatialSystem::GetSingleton()->queryFrustum(camera->getViewMatrix() * camera->getProjectionMatrix()));
+	};
+	spatialSystem["Raycast"] = [](const Vector3& origin, const Vector3& direction, float maxDistance) {
+		Vector3 normalized = direction;
+		normalized.Normalize();
+		return SpatialSystem::GetSingleton()->raycast(Ray(origin, normalized), maxDistance);
+	};
+}
+
+SpatialSystem* SpatialSystem::GetSingleton()
+{
+	static SpatialSystem singleton;
+	return &singleton;
+}
+
+void SpatialSystem::updateBounds()
+{
+	ComponentVersion version = Component::GetCurrentChangeVersion();
+	ComponentPool<TransformComponent>::GetSingleton()->forEachChangedSince(m_BoundsVersion, [this](TransformComponent* transform) {
+		if (transform->m_SpatialProxy < 0)
+		{
+			transform->m_SpatialProxy = m_Tree.insert(transform->getWorldBounds(), transform->getOwner());
+		}
+		else
+		{
+			m_Tree.move(transform->m_SpatialProxy, transform->getWorldBounds());
+		}
+	});
+	m_BoundsVersion = version;
+}
+
+void SpatialSystem::removeTransform(TransformComponent* transform)
+{
+	if (transform->m_SpatialProxy >= 0)
+	{
+		m_Tree.remove(transform->m_SpatialProxy);
+		transform->m_SpatialProxy = -1;
+	}
+}
+
+Vector<Entity*> SpatialSystem::queryBox(const BoundingBox& box) const
+{
+	Vector<Entity*> result;
+	m_Tree.queryBox(box, [&result](Entity* entity) { result.push_back(entity); });
+	return result;
+}
+
+Vector<Entity*> SpatialSystem::querySphere(const Vector3& center, float radius) const
+{
+	Vector<Entity*> result;
+	m_Tree.querySphere(center, radius, [&result](Entity* entity) { result.push_back(entity); });
+	return result;
+}
+
+Vector<Entity*> SpatialSystem::queryFrustum(const Matrix& viewProjection) const
+{
+	Vector<Entity*> result;
+	m_Tree.queryFrustum(Frustum::FromViewProjection(viewProjection), [&result](Entity* entity) { result.push_back(entity); });
+	return result;
+}
+
+Entity* SpatialSystem::raycast(const Ray& ray, float maxDistance, const Function<bool(Entity*)>& filter, float& distance) const
+{
+	return m_Tree.raycast(ray, maxDistance, filter, distance);
+}
+
+Entity* SpatialSystem::raycast(const Ray& ray, float maxDistance) const
+{
+	float distance = 0.0f;
+	return m_Tree.raycast(ray, maxDistance, [](Entity*) { return true; }, distance);
+}
+
+#ifdef ROOTEX_EDITOR
+#include "imgui.h"
+void SpatialSystem::draw()
+{
+	System::draw();
+
+	ImGui::Columns(2);
+
+	ImGui::Text("Proxies");
+	ImGui::NextColumn();
+	ImGui::Text("%d", (int)m_Tree.getLeafCount());
+	ImGui::NextColumn();
+
+	ImGui::Text("Tree Height");
+	ImGui::NextColumn();
+	ImGui::Text("%d", m_Tree.getHeight());
+	ImGui::NextColumn();
+
+	ImGui::Text("Area Ratio");
+	ImGui::NextColumn();
+	ImGui::Text("%.2f", m_Tree.getAreaRatio());
+	ImGui::NextColumn();
+
+	ImGui::Columns(1);
+}
+#endif // ROOTEX_EDITOR
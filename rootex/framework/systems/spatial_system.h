@@ -0,0 +1,40 @@
+#pragma once
+
+#include "framework/system.h"
+#include "framework/dynamic_aabb_tree.h"
+#include "components/transform_component.h"
+
+/// Spatial index over the world space bounds of every TransformComponent.
+/// Only transforms changed since the last updateBounds() are refitted, and most refits do not restructure the tree.
+class SpatialSystem : public System
+{
+	DynamicAABBTree m_Tree;
+	/// Change version at the start of the last updateBounds() pass.
+	ComponentVersion m_BoundsVersion;
+
+	SpatialSystem();
+	SpatialSystem(SpatialSystem&) = delete;
+	virtual ~SpatialSystem();
+
+public:
+	static void RegisterAPI(sol::table& rootex);
+	static SpatialSystem* GetSingleton();
+
+	/// Inserts new transforms and refits the ones changed since the last call. Call after HierarchySystem::updateTransforms().
+	void updateBounds();
+	void removeTransform(TransformComponent* transform);
+
+	/// Entities whose world bounds overlap the query. Results reflect the bounds as of the last updateBounds().
+	Vector<Entity*> queryBox(const BoundingBox& box) const;
+	Vector<Entity*> querySphere(const Vector3& center, float radius) const;
+	Vector<Entity*> queryFrustum(const Matrix& viewProjection) const;
+	/// Closest entity hit within maxDistance for which filter is true. Returns nullptr on a miss.
+	Entity* raycast(const Ray& ray, float maxDistance, const Function<bool(Entity*)>& filter, float& distance) const;
+	Entity* raycast(const Ray& ray, float maxDistance) const;
+
+	const DynamicAABBTree& getTree() const { return m_Tree; }
+
+#ifdef ROOTEX_EDITOR
+	void draw() override;
+#endif // ROOTEX_EDITOR
+};
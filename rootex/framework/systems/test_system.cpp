@@ -5,13 +5,12 @@
 TestSystem::TestSystem()
     : System("TestSystem", UpdateOrder::Async, false)
 {
+	declareComponentAccess({ TestComponent::s_ID }, {});
 }
 
 void TestSystem::update(float deltaMilliseconds)
 {
-	const Vector<Component*>& testComponents = s_Components[TestComponent::s_ID];
-
-	for (auto& testComponent : testComponents)
+	for (TestComponent* testComponent : *ComponentPool<TestComponent>::GetSingleton())
 	{
 		OS::PrintWarning("TestComponent was processed by TestSystem");
 	}
@@ -1,6 +1,7 @@
 #include "transform_animation_system.h"
 
 #include "components/transform_animation_component.h"
+#include "components/transform_component.h"
 
 TransformAnimationSystem* TransformAnimationSystem::GetSingleton()
 {
@@ -11,15 +12,14 @@ TransformAnimationSystem* TransformAnimationSystem::GetSingleton()
 TransformAnimationSystem::TransformAnimationSystem()
     : System("TransformationAnimationSystem", UpdateOrder::Update, true)
 {
+	// Transforms are only written in sync(), after the other systems of the bucket are done reading them
+	declareComponentAccess({ TransformAnimationComponent::s_ID }, { TransformAnimationComponent::s_ID });
 }
 
 void TransformAnimationSystem::begin()
 {
-	TransformAnimationComponent* animation = nullptr;
-	for (auto& component : s_Components[TransformAnimationComponent::s_ID])
+	for (TransformAnimationComponent* animation : *ComponentPool<TransformAnimationComponent>::GetSingleton())
 	{
-		animation = (TransformAnimationComponent*)component;
-		
 		if (animation->isPlayOnStart())
 		{
 			animation->setPlaying(true);
@@ -29,22 +29,46 @@ void TransformAnimationSystem::begin()
 
 void TransformAnimationSystem::update(float deltaMilliseconds)
 {
-	TransformAnimationComponent* animation = nullptr;
-	for (auto& component : s_Components[TransformAnimationComponent::s_ID])
-	{
-		animation = (TransformAnimationComponent*)component;
+	m_Batch.clear();
+	m_BatchTargets.clear();
 
+	Vector3 translation;
+	Quaternion rotation;
+	Vector3 scale;
+	for (TransformAnimationComponent* animation : *ComponentPool<TransformAnimationComponent>::GetSingleton())
+	{
 		if (animation->isPlaying() && !animation->hasEnded())
 		{
 			animation->m_CurrentTimePosition += deltaMilliseconds * MS_TO_S;
 
-
-			animation->interpolate(animation->m_CurrentTimePosition);
+			// Looping animations that just ended are restarted below, which overrides this frame's sample
+			bool isRestarting = animation->isLooping() && animation->hasEnded();
+			if (!isRestarting && animation->sample(animation->m_CurrentTimePosition, translation, rotation, scale))
+			{
+				m_Batch.push(translation, rotation, scale);
+				m_BatchTargets.push_back(animation->m_TransformComponent);
+			}
 		}
 		
 		if (animation->isLooping() && animation->hasEnded())
 		{
-			animation->reset();
+			// Same as reset(), without writing the transform from this thread
+			animation->m_CurrentTimePosition = 0.0f;
+			if (animation->sample(0.0f, translation, rotation, scale))
+			{
+				m_Batch.push(translation, rotation, scale);
+				m_BatchTargets.push_back(animation->m_TransformComponent);
+			}
 		}
 	}
+
+	m_Batch.compose();
+}
+
+void TransformAnimationSystem::sync()
+{
+	for (size_t i = 0; i < m_BatchTargets.size(); i++)
+	{
+		m_BatchTargets[i]->setComposedTransform(m_Batch.getPosition(i), m_Batch.getRotation(i), m_Batch.getScale(i), m_Batch.getMatrix(i));
+	}
 }
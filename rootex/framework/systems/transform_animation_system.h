@@ -1,14 +1,24 @@
 #pragma once
 
 #include "system.h"
+#include "transform_batch.h"
+
+class TransformComponent;
 
 class TransformAnimationSystem : public System
 {
+	/// Sampled transforms of this frame, composed together before being written back.
+	TransformBatch m_Batch;
+	Vector<TransformComponent*> m_BatchTargets;
+
 public:
 	static TransformAnimationSystem* GetSingleton();
 
 	TransformAnimationSystem();
 
 	void begin();
+	/// Samples and composes the transforms of playing animations.
 	void update(float deltaMilliseconds) override;
+	/// Writes the transforms composed in update().
+	void sync() override;
 };
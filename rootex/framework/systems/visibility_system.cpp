@@ -0,0 +1,382 @@
+#include "visibility_system.h"
+
+#include "hierarchy_system.h"
+#include "app/application.h"
+
+#include <xmmintrin.h>
+
+VisibilitySystem::VisibilitySystem()
+    : System("VisibilitySystem", UpdateOrder::Async, false)
+    , m_OcclusionBuffer(OCCLUSION_BUFFER_WIDTH, OCCLUSION_BUFFER_HEIGHT)
+    , m_IsOcclusionCullingEnabled(true)
+    , m_IsTemporalCachingEnabled(true)
+    , m_IsCacheValid(false)
+    , m_CachedVersion(0)
+    , m_Frame(0)
+{
+}
+
+void VisibilitySystem::RegisterAPI(sol::table& rootex)
+{
+	sol::usertype<VisibilitySystem> visibilitySystem = rootex.new_usertype<VisibilitySystem>("VisibilitySystem");
+	visibilitySystem["GetTestedCount"] = []() { return VisibilitySystem::GetSingleton()->getStatistics().m_Tested; };
+	visibilitySystem["GetReusedCount"] = []() { return VisibilitySystem::GetSingleton()->getStatistics().m_Reused; };
+	visibilitySystem["GetCulledCount"] = []() { return VisibilitySystem::GetSingleton()->getStatistics().m_Culled; };
+	visibilitySystem["GetOccludedCount"] = []() { return VisibilitySystem::GetSingleton()->getStatistics().m_Occluded; };
+	visibilitySystem["GetVisibleCount"] = []() { return VisibilitySystem::GetSingleton()->getStatistics().m_Visible; };
+	visibilitySystem["SetOcclusionCullingEnabled"] = [](bool enabled) { VisibilitySystem::GetSingleton()->setOcclusionCullingEnabled(enabled); };
+	visibilitySystem["SetTemporalCachingEnabled"] = [](bool enabled) { VisibilitySystem::GetSingleton()->setTemporalCachingEnabled(enabled); };
+	visibilitySystem["Invalidate"] = []() { VisibilitySystem::GetSingleton()->invalidate(); };
+	visibilitySystem["SaveOcclusionBuffer"] = [](const String& path) { return VisibilitySystem::GetSingleton()->getOcclusionBuffer().saveImage(path); };
+}
+
+VisibilitySystem* VisibilitySystem::GetSingleton()
+{
+	static VisibilitySystem singleton;
+	return &singleton;
+}
+
+bool VisibilitySystem::isChanged(const ModelComponent* model) const
+{
+	return model->hasChangedSince(m_CachedVersion) || model->m_TransformComponent->hasChangedSince(m_CachedVersion);
+}
+
+void VisibilitySystem::cull(const Matrix& viewProjection)
+{
+	const ComponentVersion version = Component::GetCurrentChangeVersion();
+	if (!m_IsTemporalCachingEnabled)
+	{
+		m_IsCacheValid = false;
+	}
+
+	m_Models.clear();
+	m_CenterX.clear();
+	m_CenterY.clear();
+	m_CenterZ.clear();
+	m_ExtentsX.clear();
+	m_ExtentsY.clear();
+	m_ExtentsZ.clear();
+	m_Statistics = VisibilityStatistics();
+
+	const Vector<Component*>& models = System::GetComponents(ModelComponent::s_ID);
+
+	// Everything outside the grown frustum is also outside any frustum inside it, so results hold until the camera frustum leaves it
+	Vector3 corners[8];
+	Frustum::GetCorners(viewProjection, corners);
+	bool isCameraInside = m_IsCacheValid;
+	for (int i = 0; i < 8 && isCameraInside; i++)
+	{
+		isCameraInside = m_CachedFrustum.isInside(corners[i]);
+	}
+	if (!isCameraInside)
+	{
+		m_CachedFrustum = Frustum::FromViewProjection(viewProjection).inflated(VISIBILITY_FRUSTUM_MARGIN);
+		gatherHierarchy(m_CachedFrustum);
+	}
+	else
+	{
+		for (Component* component : models)
+		{
+			ModelComponent* model = (ModelComponent*)component;
+			if (!model->isCullable() || !model->m_TransformComponent)
+			{
+				model->m_IsOutsideFrustum = false;
+			}
+			else if (isChanged(model))
+			{
+				gatherModel(model);
+			}
+			else
+			{
+				m_Statistics.m_Reused++;
+			}
+		}
+	}
+
+	cullGathered(m_CachedFrustum);
+	m_Statistics.m_Tested += m_Models.size();
+
+	cullOccluded(viewProjection);
+
+	for (Component* component : models)
+	{
+		ModelComponent* model = (ModelComponent*)component;
+		model->m_IsCulled = model->m_IsOutsideFrustum || model->m_IsOccluded;
+		if (model->m_IsOutsideFrustum)
+		{
+			m_Statistics.m_Culled++;
+		}
+		else if (model->m_IsOccluded)
+		{
+			m_Statistics.m_Occluded++;
+		}
+		else if (model->isVisible())
+		{
+			m_Statistics.m_Visible++;
+		}
+	}
+
+	m_CachedVersion = version;
+	m_IsCacheValid = true;
+	m_Frame++;
+}
+
+void VisibilitySystem::gatherModel(ModelComponent* model)
+{
+	const BoundingBox bounds = model->m_TransformComponent->getWorldBounds();
+	m_Models.push_back(model);
+	m_CenterX.push_back(bounds.Center.x);
+	m_CenterY.push_back(bounds.Center.y);
+	m_CenterZ.push_back(bounds.Center.z);
+	m_ExtentsX.push_back(bounds.Extents.x);
+	m_ExtentsY.push_back(bounds.Extents.y);
+	m_ExtentsZ.push_back(bounds.Extents.z);
+}
+
+void VisibilitySystem::gatherHierarchy(const Frustum& frustum)
+{
+	const Vector<HierarchySystem::TransformNode>& nodes = HierarchySystem::GetSingleton()->getTransformNodes();
+	m_NodeContainments.resize(nodes.size());
+	m_IsInteriorNode.assign(nodes.size(), 0);
+	for (const HierarchySystem::TransformNode& node : nodes)
+	{
+		if (node.m_ParentIndex >= 0)
+		{
+			m_IsInteriorNode[node.m_ParentIndex] = 1;
+		}
+	}
+
+	// Parents come before their children, so each node inherits the verdict on its parent subtree.
+	// Only subtrees straddling the frustum get their bounds tested. The hierarchy bounds of a leaf are its own bounds,
+	// so leaves left undecided are gathered and tested 4 at a time instead.
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		const HierarchySystem::TransformNode& node = nodes[i];
+		DirectX::ContainmentType containment = node.m_ParentIndex >= 0 ? m_NodeContainments[node.m_ParentIndex] : DirectX::INTERSECTS;
+		if (containment == DirectX::INTERSECTS && m_IsInteriorNode[i])
+		{
+			// A subtree without fitted bounds holds nothing that could be drawn
+			if (!node.m_Transform->hasHierarchyBounds())
+			{
+				containment = DirectX::DISJOINT;
+			}
+			else
+			{
+				containment = frustum.contains(AABB::FromBoundingBox(node.m_Transform->getHierarchyBounds()));
+				m_Statistics.m_Tested++;
+			}
+		}
+		m_NodeContainments[i] = containment;
+
+		ModelComponent* model = node.m_Transform->getOwner()->getComponentPtr<ModelComponent>();
+		if (!model)
+		{
+			continue;
+		}
+
+		model->m_VisibilityFrame = m_Frame;
+		if (!model->isCullable())
+		{
+			model->m_IsOutsideFrustum = false;
+		}
+		else if (containment == DirectX::INTERSECTS)
+		{
+			gatherModel(model);
+		}
+		else
+		{
+			model->m_IsOutsideFrustum = containment == DirectX::DISJOINT;
+		}
+	}
+
+	// Models of entities outside the hierarchy are not reached by the walk
+	for (Component* component : System::GetComponents(ModelComponent::s_ID))
+	{
+		ModelComponent* model = (ModelComponent*)component;
+		if (model->m_VisibilityFrame == m_Frame)
+		{
+			continue;
+		}
+		if (!model->isCullable() || !model->m_TransformComponent)
+		{
+			model->m_IsOutsideFrustum = false;
+		}
+		else
+		{
+			gatherModel(model);
+		}
+	}
+}
+
+void VisibilitySystem::cullOccluded(const Matrix& viewProjection)
+{
+	const Vector<Component*>& models = System::GetComponents(ModelComponent::s_ID);
+
+	m_Occluders.clear();
+	bool isOccludersChanged = false;
+	if (m_IsOcclusionCullingEnabled)
+	{
+		for (Component* component : models)
+		{
+			ModelComponent* model = (ModelComponent*)component;
+			if (model->isOccluder() && model->isVisible() && !model->m_IsOutsideFrustum && model->m_TransformComponent && model->m_ModelResourceFile)
+			{
+				m_Occluders.push_back(model);
+				isOccludersChanged |= isChanged(model);
+			}
+		}
+	}
+	isOccludersChanged |= m_Occluders != m_RasterizedOccluders;
+
+	const bool isRasterized = !m_IsCacheValid || isOccludersChanged || viewProjection != m_RasterizedViewProjection;
+	if (isRasterized)
+	{
+		m_OcclusionBuffer.begin(viewProjection);
+		for (ModelComponent* occluder : m_Occluders)
+		{
+			const ModelResourceFile* file = occluder->m_ModelResourceFile;
+			m_OcclusionBuffer.addOccluder(file->getPositions(), file->getIndices(), occluder->m_TransformComponent->getAbsoluteTransform());
+		}
+		if (m_OcclusionBuffer.getTriangleCount() > 0)
+		{
+			m_OcclusionBuffer.rasterize(&Application::GetSingleton()->getThreadPool());
+		}
+		m_RasterizedOccluders.swap(m_Occluders);
+		m_RasterizedViewProjection = viewProjection;
+	}
+	m_Statistics.m_OccluderTriangles = m_OcclusionBuffer.getTriangleCount();
+
+	for (size_t i = 0; i < models.size(); i++)
+	{
+		ModelComponent* model = (ModelComponent*)models[i];
+		if (m_Statistics.m_OccluderTriangles == 0 || model->m_IsOutsideFrustum || model->isOccluder() || !model->isCullable() || !model->m_TransformComponent)
+		{
+			model->m_IsOccluded = false;
+			continue;
+		}
+
+		// Occluded models are always tested again so that they reappear as soon as they are uncovered.
+		// Visible models are only drawn needlessly until their turn comes.
+		bool isRetested = !m_IsCacheValid || isChanged(model);
+		if (isRasterized)
+		{
+			isRetested |= model->m_IsOccluded || (i % VISIBILITY_OCCLUSION_RETEST_PERIOD) == (m_Frame % VISIBILITY_OCCLUSION_RETEST_PERIOD);
+		}
+		if (isRetested)
+		{
+			model->m_IsOccluded = !m_OcclusionBuffer.isVisible(model->m_TransformComponent->getWorldBounds());
+			m_Statistics.m_OcclusionTested++;
+		}
+	}
+}
+
+void VisibilitySystem::cullGathered(const Frustum& frustum)
+{
+	const size_t count = m_Models.size();
+	const size_t simdCount = count - count % 4;
+
+	__m128 planeX[6];
+	__m128 planeY[6];
+	__m128 planeZ[6];
+	__m128 planeW[6];
+	__m128 planeAbsX[6];
+	__m128 planeAbsY[6];
+	__m128 planeAbsZ[6];
+	for (int p = 0; p < 6; p++)
+	{
+		const Vector4& plane = frustum.m_Planes[p];
+		planeX[p] = _mm_set1_ps(plane.x);
+		planeY[p] = _mm_set1_ps(plane.y);
+		planeZ[p] = _mm_set1_ps(plane.z);
+		planeW[p] = _mm_set1_ps(plane.w);
+		planeAbsX[p] = _mm_set1_ps(fabsf(plane.x));
+		planeAbsY[p] = _mm_set1_ps(fabsf(plane.y));
+		planeAbsZ[p] = _mm_set1_ps(fabsf(plane.z));
+	}
+
+	for (size_t i = 0; i < simdCount; i += 4)
+	{
+		__m128 centerX = _mm_loadu_ps(&m_CenterX[i]);
+		__m128 centerY = _mm_loadu_ps(&m_CenterY[i]);
+		__m128 centerZ = _mm_loadu_ps(&m_CenterZ[i]);
+		__m128 extentsX = _mm_loadu_ps(&m_ExtentsX[i]);
+		__m128 extentsY = _mm_loadu_ps(&m_ExtentsY[i]);
+		__m128 extentsZ = _mm_loadu_ps(&m_ExtentsZ[i]);
+
+		// A box is outside if its center lies further in front of any plane than the box reaches towards it
+		__m128 isOutside = _mm_setzero_ps();
+		for (int p = 0; p < 6; p++)
+		{
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(centerX, planeX[p]), _mm_mul_ps(centerY, planeY[p])), _mm_add_ps(_mm_mul_ps(centerZ, planeZ[p]), planeW[p]));
+			__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(extentsX, planeAbsX[p]), _mm_mul_ps(extentsY, planeAbsY[p])), _mm_mul_ps(extentsZ, planeAbsZ[p]));
+			isOutside = _mm_or_ps(isOutside, _mm_cmpgt_ps(distance, radius));
+		}
+
+		int outsideMask = _mm_movemask_ps(isOutside);
+		for (size_t j = 0; j < 4; j++)
+		{
+			m_Models[i + j]->m_IsOutsideFrustum = (outsideMask & (1 << j)) != 0;
+		}
+	}
+
+	for (size_t i = simdCount; i < count; i++)
+	{
+		Vector3 center(m_CenterX[i], m_CenterY[i], m_CenterZ[i]);
+		Vector3 extents(m_ExtentsX[i], m_ExtentsY[i], m_ExtentsZ[i]);
+		m_Models[i]->m_IsOutsideFrustum = !frustum.intersects({ center - extents, center + extents });
+	}
+}
+
+#ifdef ROOTEX_EDITOR
+#include "imgui.h"
+void VisibilitySystem::draw()
+{
+	System::draw();
+
+	ImGui::Columns(2);
+
+	ImGui::Text("Tested");
+	ImGui::NextColumn();
+	ImGui::Text("%d", (int)m_Statistics.m_Tested);
+	ImGui::NextColumn();
+
+	ImGui::Text("Reused");
+	ImGui::NextColumn();
+	ImGui::Text("%d", (int)m_Statistics.m_Reused);
+	ImGui::NextColumn();
+
+	ImGui::Text("Culled");
+	ImGui::NextColumn();
+	ImGui::Text("%d", (int)m_Statistics.m_Culled);
+	ImGui::NextColumn();
+
+	ImGui::Text("Occlusion Tested");
+	ImGui::NextColumn();
+	ImGui::Text("%d", (int)m_Statistics.m_OcclusionTested);
+	ImGui::NextColumn();
+
+	ImGui::Text("Occluded");
+	ImGui::NextColumn();
+	ImGui::Text("%d", (int)m_Statistics.m_Occluded);
+	ImGui::NextColumn();
+
+	ImGui::Text("Occluder Triangles");
+	ImGui::NextColumn();
+	ImGui::Text("%d", (int)m_Statistics.m_OccluderTriangles);
+	ImGui::NextColumn();
+
+	ImGui::Text("Visible");
+	ImGui::NextColumn();
+	ImGui::Text("%d", (int)m_Statistics.m_Visible);
+	ImGui::NextColumn();
+
+	ImGui::Columns(1);
+
+	ImGui::Checkbox("Temporal Caching", &m_IsTemporalCachingEnabled);
+	ImGui::Checkbox("Occlusion Culling", &m_IsOcclusionCullingEnabled);
+	if (ImGui::Button("Save Occlusion Buffer"))
+	{
+		m_OcclusionBuffer.saveImage("occlusion_buffer.bmp");
+	}
+}
+#endif // ROOTEX_EDITOR
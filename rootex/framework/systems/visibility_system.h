@@ -0,0 +1,110 @@
+#pragma once
+
+#include "framework/system.h"
+#include "framework/dynamic_aabb_tree.h"
+#include "framework/occlusion_buffer.h"
+#include "components/visual/model_component.h"
+
+/// Resolution of the depth buffer occluders are rasterized into.
+#define OCCLUSION_BUFFER_WIDTH 256
+#define OCCLUSION_BUFFER_HEIGHT 144
+/// Distance in world units by which the frustum is grown when testing models, so that results can be kept while the camera moves a little.
+#define VISIBILITY_FRUSTUM_MARGIN 2.0f
+/// Number of frames over which unchanged visible models get tested again against a newly rasterized occlusion buffer.
+#define VISIBILITY_OCCLUSION_RETEST_PERIOD 4
+
+/// Counts of the last visibility pass.
+struct VisibilityStatistics
+{
+	/// Boxes tested against the frustum, counting both hierarchy bounds and model bounds.
+	size_t m_Tested = 0;
+	/// Models whose frustum result was kept from an earlier frame.
+	size_t m_Reused = 0;
+	/// Models found outside the frustum.
+	size_t m_Culled = 0;
+	/// Models tested against the occlusion buffer.
+	size_t m_OcclusionTested = 0;
+	/// Models inside the frustum found hidden behind occluders.
+	size_t m_Occluded = 0;
+	/// Occluder triangles rasterized into the occlusion buffer.
+	size_t m_OccluderTriangles = 0;
+	/// Models drawn this frame: marked visible, and neither culled nor occluded. Includes the ones that cannot be culled.
+	size_t m_Visible = 0;
+};
+
+/// Decides which models are worth submitting for drawing each frame, by testing their world bounds against the camera frustum.
+/// The hierarchy is walked top down using hierarchy bounds, so subtrees entirely outside or inside the frustum are decided with a single test.
+/// Model bounds left to test are gathered in structure of arrays form and tested 4 at a time using SSE.
+/// Models marked as occluders are then rasterized into a CPU depth buffer, and models left inside the frustum are tested against it.
+/// Results are kept across frames. Models are tested against the frustum grown by VISIBILITY_FRUSTUM_MARGIN, and while the camera frustum
+/// stays inside that grown frustum, only changed models are tested again. Models near the frustum may be drawn needlessly, but never popped.
+/// Models previously found occluded are tested against every new occlusion buffer, while visible ones are spread over VISIBILITY_OCCLUSION_RETEST_PERIOD frames.
+class VisibilitySystem : public System
+{
+	Vector<ModelComponent*> m_Models;
+	Vector<float> m_CenterX;
+	Vector<float> m_CenterY;
+	Vector<float> m_CenterZ;
+	Vector<float> m_ExtentsX;
+	Vector<float> m_ExtentsY;
+	Vector<float> m_ExtentsZ;
+
+	/// Verdict on the hierarchy bounds of each node of HierarchySystem::getTransformNodes().
+	Vector<DirectX::ContainmentType> m_NodeContainments;
+	/// Marks the nodes of HierarchySystem::getTransformNodes() that have children.
+	Vector<char> m_IsInteriorNode;
+
+	OcclusionBuffer m_OcclusionBuffer;
+	bool m_IsOcclusionCullingEnabled;
+	Vector<ModelComponent*> m_Occluders;
+	Vector<ModelComponent*> m_RasterizedOccluders;
+	Matrix m_RasterizedViewProjection;
+
+	bool m_IsTemporalCachingEnabled;
+	/// False until the first pass and after invalidate(), forcing every model to be tested.
+	bool m_IsCacheValid;
+	/// Grown frustum the kept results were tested against.
+	Frustum m_CachedFrustum;
+	ComponentVersion m_CachedVersion;
+	unsigned int m_Frame;
+
+	VisibilityStatistics m_Statistics;
+
+	VisibilitySystem();
+	VisibilitySystem(VisibilitySystem&) = delete;
+	virtual ~VisibilitySystem() = default;
+
+	/// True if the model or its transform changed after the last pass.
+	bool isChanged(const ModelComponent* model) const;
+	/// Queues the world bounds of model for cullGathered().
+	void gatherModel(ModelComponent* model);
+	/// Walks the hierarchy top down, deciding whole subtrees at once and gathering the models left to test.
+	/// Only nodes with children have their hierarchy bounds tested, leaves left undecided are gathered along with models outside the hierarchy.
+	void gatherHierarchy(const Frustum& frustum);
+	/// Tests all gathered bounds against the frustum and marks the models outside it.
+	void cullGathered(const Frustum& frustum);
+	/// Rasterizes the occluders inside the frustum if they or the camera changed and marks models hidden behind them.
+	void cullOccluded(const Matrix& viewProjection);
+
+public:
+	static void RegisterAPI(sol::table& rootex);
+	static VisibilitySystem* GetSingleton();
+
+	/// Marks every model outside the frustum of viewProjection as culled. Call after HierarchySystem::updateTransforms().
+	void cull(const Matrix& viewProjection);
+
+	/// Drops the results kept from earlier frames, so that the next pass tests every model.
+	void invalidate() { m_IsCacheValid = false; }
+	void setTemporalCachingEnabled(bool enabled) { m_IsTemporalCachingEnabled = enabled; }
+	bool isTemporalCachingEnabled() const { return m_IsTemporalCachingEnabled; }
+	void setOcclusionCullingEnabled(bool enabled) { m_IsOcclusionCullingEnabled = enabled; }
+	bool isOcclusionCullingEnabled() const { return m_IsOcclusionCullingEnabled; }
+	/// Depths rasterized in the last visibility pass.
+	const OcclusionBuffer& getOcclusionBuffer() const { return m_OcclusionBuffer; }
+
+	const VisibilityStatistics& getStatistics() const { return m_Statistics; }
+
+#ifdef ROOTEX_EDITOR
+	void draw() override;
+#endif // ROOTEX_EDITOR
+};
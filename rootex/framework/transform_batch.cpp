@@ -0,0 +1,209 @@
+#include "transform_batch.h"
+
+#include "core/random.h"
+#include "os/timer.h"
+
+#include <xmmintrin.h>
+
+void TransformBatch::RegisterAPI(sol::table& rootex)
+{
+	sol::usertype<TransformBatch> transformBatch = rootex.new_usertype<TransformBatch>("TransformBatch");
+	transformBatch["Benchmark"] = &TransformBatch::Benchmark;
+}
+
+void TransformBatch::Benchmark(size_t count)
+{
+	TransformBatch batch;
+	batch.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		Quaternion rotation = Quaternion::CreateFromYawPitchRoll(Random::Float() * 6.28f, Random::Float() * 6.28f, Random::Float() * 6.28f);
+		batch.push({ Random::Float(), Random::Float(), Random::Float() }, rotation, { Random::Float(), Random::Float(), Random::Float() });
+	}
+	Vector<Matrix> results(count);
+
+	StopTimer timer;
+	for (size_t i = 0; i < count; i++)
+	{
+		results[i] = Matrix::CreateScale(batch.getScale(i)) * Matrix::CreateFromQuaternion(batch.getRotation(i)) * Matrix::CreateTranslation(batch.getPosition(i));
+	}
+	float productTime = timer.getTimeMs();
+
+	timer.reset();
+	for (size_t i = 0; i < count; i++)
+	{
+		Compose(batch.getPosition(i), batch.getRotation(i), batch.getScale(i), results[i]);
+	}
+	float scalarTime = timer.getTimeMs();
+
+	timer.reset();
+	batch.compose();
+	float batchTime = timer.getTimeMs();
+
+	PRINT("Composed " + std::to_string(count) + " transforms. Matrix products: " + std::to_string(productTime) + "ms, scalar: " + std::to_string(scalarTime) + "ms, SSE batch: " + std::to_string(batchTime) + "ms");
+}
+
+void TransformBatch::Compose(const Vector3& position, const Quaternion& rotation, const Vector3& scale, Matrix& result)
+{
+	float x2 = rotation.x + rotation.x;
+	float y2 = rotation.y + rotation.y;
+	float z2 = rotation.z + rotation.z;
+
+	float xx = rotation.x * x2;
+	float xy = rotation.x * y2;
+	float xz = rotation.x * z2;
+	float yy = rotation.y * y2;
+	float yz = rotation.y * z2;
+	float zz = rotation.z * z2;
+	float wx = rotation.w * x2;
+	float wy = rotation.w * y2;
+	float wz = rotation.w * z2;
+
+	result._11 = (1.0f - (yy + zz)) * scale.x;
+	result._12 = (xy + wz) * scale.x;
+	result._13 = (xz - wy) * scale.x;
+	result._14 = 0.0f;
+
+	result._21 = (xy - wz) * scale.y;
+	result._22 = (1.0f - (xx + zz)) * scale.y;
+	result._23 = (yz + wx) * scale.y;
+	result._24 = 0.0f;
+
+	result._31 = (xz + wy) * scale.z;
+	result._32 = (yz - wx) * scale.z;
+	result._33 = (1.0f - (xx + yy)) * scale.z;
+	result._34 = 0.0f;
+
+	result._41 = position.x;
+	result._42 = position.y;
+	result._43 = position.z;
+	result._44 = 1.0f;
+}
+
+void TransformBatch::reserve(size_t count)
+{
+	m_PositionX.reserve(count);
+	m_PositionY.reserve(count);
+	m_PositionZ.reserve(count);
+	m_RotationX.reserve(count);
+	m_RotationY.reserve(count);
+	m_RotationZ.reserve(count);
+	m_RotationW.reserve(count);
+	m_ScaleX.reserve(count);
+	m_ScaleY.reserve(count);
+	m_ScaleZ.reserve(count);
+	m_Matrices.reserve(count);
+}
+
+void TransformBatch::clear()
+{
+	m_PositionX.clear();
+	m_PositionY.clear();
+	m_PositionZ.clear();
+	m_RotationX.clear();
+	m_RotationY.clear();
+	m_RotationZ.clear();
+	m_RotationW.clear();
+	m_ScaleX.clear();
+	m_ScaleY.clear();
+	m_ScaleZ.clear();
+	m_Matrices.clear();
+}
+
+size_t TransformBatch::push(const Vector3& position, const Quaternion& rotation, const Vector3& scale)
+{
+	m_PositionX.push_back(position.x);
+	m_PositionY.push_back(position.y);
+	m_PositionZ.push_back(position.z);
+	m_RotationX.push_back(rotation.x);
+	m_RotationY.push_back(rotation.y);
+	m_RotationZ.push_back(rotation.z);
+	m_RotationW.push_back(rotation.w);
+	m_ScaleX.push_back(scale.x);
+	m_ScaleY.push_back(scale.y);
+	m_ScaleZ.push_back(scale.z);
+	m_Matrices.emplace_back();
+	return m_Matrices.size() - 1;
+}
+
+void TransformBatch::compose()
+{
+	const size_t count = size();
+	const size_t simdCount = count - count % 4;
+
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (size_t i = 0; i < simdCount; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(&m_RotationX[i]);
+		__m128 y = _mm_loadu_ps(&m_RotationY[i]);
+		__m128 z = _mm_loadu_ps(&m_RotationZ[i]);
+		__m128 w = _mm_loadu_ps(&m_RotationW[i]);
+
+		__m128 x2 = _mm_add_ps(x, x);
+		__m128 y2 = _mm_add_ps(y, y);
+		__m128 z2 = _mm_add_ps(z, z);
+
+		__m128 xx = _mm_mul_ps(x, x2);
+		__m128 xy = _mm_mul_ps(x, y2);
+		__m128 xz = _mm_mul_ps(x, z2);
+		__m128 yy = _mm_mul_ps(y, y2);
+		__m128 yz = _mm_mul_ps(y, z2);
+		__m128 zz = _mm_mul_ps(z, z2);
+		__m128 wx = _mm_mul_ps(w, x2);
+		__m128 wy = _mm_mul_ps(w, y2);
+		__m128 wz = _mm_mul_ps(w, z2);
+
+		__m128 sx = _mm_loadu_ps(&m_ScaleX[i]);
+		__m128 sy = _mm_loadu_ps(&m_ScaleY[i]);
+		__m128 sz = _mm_loadu_ps(&m_ScaleZ[i]);
+
+		// Each register holds one matrix element for 4 consecutive entries
+		__m128 m11 = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx);
+		__m128 m12 = _mm_mul_ps(_mm_add_ps(xy, wz), sx);
+		__m128 m13 = _mm_mul_ps(_mm_sub_ps(xz, wy), sx);
+		__m128 m14 = zero;
+
+		__m128 m21 = _mm_mul_ps(_mm_sub_ps(xy, wz), sy);
+		__m128 m22 = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy);
+		__m128 m23 = _mm_mul_ps(_mm_add_ps(yz, wx), sy);
+		__m128 m24 = zero;
+
+		__m128 m31 = _mm_mul_ps(_mm_add_ps(xz, wy), sz);
+		__m128 m32 = _mm_mul_ps(_mm_sub_ps(yz, wx), sz);
+		__m128 m33 = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz);
+		__m128 m34 = zero;
+
+		__m128 m41 = _mm_loadu_ps(&m_PositionX[i]);
+		__m128 m42 = _mm_loadu_ps(&m_PositionY[i]);
+		__m128 m43 = _mm_loadu_ps(&m_PositionZ[i]);
+		__m128 m44 = one;
+
+		// Turn element-per-register into row-per-register, one row of each of the 4 matrices
+		_MM_TRANSPOSE4_PS(m11, m12, m13, m14);
+		_MM_TRANSPOSE4_PS(m21, m22, m23, m24);
+		_MM_TRANSPOSE4_PS(m31, m32, m33, m34);
+		_MM_TRANSPOSE4_PS(m41, m42, m43, m44);
+
+		const __m128 rows[4][4] = {
+			{ m11, m21, m31, m41 },
+			{ m12, m22, m32, m42 },
+			{ m13, m23, m33, m43 },
+			{ m14, m24, m34, m44 }
+		};
+		for (size_t j = 0; j < 4; j++)
+		{
+			float* matrix = &m_Matrices[i + j]._11;
+			_mm_storeu_ps(matrix + 0, rows[j][0]);
+			_mm_storeu_ps(matrix + 4, rows[j][1]);
+			_mm_storeu_ps(matrix + 8, rows[j][2]);
+			_mm_storeu_ps(matrix + 12, rows[j][3]);
+		}
+	}
+
+	for (size_t i = simdCount; i < count; i++)
+	{
+		Compose(getPosition(i), getRotation(i), getScale(i), m_Matrices[i]);
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "common/common.h"
+
+/// Structure of arrays storage of positions, rotations and scales, composed into local matrices in bulk.
+/// Matrices follow the TransformComponent convention of scale, then rotation, then translation.
+class TransformBatch
+{
+	Vector<float> m_PositionX;
+	Vector<float> m_PositionY;
+	Vector<float> m_PositionZ;
+	Vector<float> m_RotationX;
+	Vector<float> m_RotationY;
+	Vector<float> m_RotationZ;
+	Vector<float> m_RotationW;
+	Vector<float> m_ScaleX;
+	Vector<float> m_ScaleY;
+	Vector<float> m_ScaleZ;
+	Vector<Matrix> m_Matrices;
+
+public:
+	static void RegisterAPI(sol::table& rootex);
+	/// Times composing count random transforms with matrix products, the scalar Compose() and the SSE compose(), and prints the results.
+	static void Benchmark(size_t count);
+	/// Composes a single matrix. Performs the same arithmetic as compose() does for every entry.
+	static void Compose(const Vector3& position, const Quaternion& rotation, const Vector3& scale, Matrix& result);
+
+	TransformBatch() = default;
+	TransformBatch(TransformBatch&) = delete;
+	~TransformBatch() = default;
+
+	void reserve(size_t count);
+	void clear();
+	/// Returns the position of the new entry.
+	size_t push(const Vector3& position, const Quaternion& rotation, const Vector3& scale);
+
+	/// Composes the matrices of all entries, 4 at a time using SSE.
+	void compose();
+
+	size_t size() const { return m_Matrices.size(); }
+	Vector3 getPosition(size_t index) const { return { m_PositionX[index], m_PositionY[index], m_PositionZ[index] }; }
+	Quaternion getRotation(size_t index) const { return { m_RotationX[index], m_RotationY[index], m_RotationZ[index], m_RotationW[index] }; }
+	Vector3 getScale(size_t index) const { return { m_ScaleX[index], m_ScaleY[index], m_ScaleZ[index] }; }
+	/// Valid after compose().
+	const Matrix& getMatrix(size_t index) const { return m_Matrices[index]; }
+};
@@ -5,13 +5,20 @@
 DWORD WINAPI MainLoop(LPVOID voidParameters);
 
 Task::Task(const Function<void()>& executionTask)
-    : m_ExecutionTask(executionTask)
+    : m_IsClaimed(false)
+    , m_BatchRemaining(nullptr)
+    , m_ExecutionTask(executionTask)
 {
 }
 
-void Task::execute()
+bool Task::execute()
 {
+	if (m_IsClaimed.exchange(true))
+	{
+		return false;
+	}
 	m_ExecutionTask();
+	return true;
 }
 
 void ThreadPool::initialize()
@@ -26,23 +33,11 @@ void ThreadPool::initialize()
 	InitializeConditionVariable(&m_ProducerVariable);
 	InitializeCriticalSection(&m_CriticalSection);
 
-	m_DefaultWorkerParameter.m_Thread = 0;
-	m_DefaultWorkerParameter.m_ThreadPool = NULL;
-
-	{
-		m_TaskQueue.m_Read = 0;
-		m_TaskQueue.m_Write = 0;
-		m_TaskQueue.m_Jobs = 0;
-		m_TasksFinished = 0;
-		m_TasksComplete.m_Jobs = 0;
-	}
-
-	for (__int32 iThread = 0; iThread < m_Threads; iThread++)
-	{
-		m_WorkerParameters.push_back(m_DefaultWorkerParameter);
-		m_Handles.push_back(m_DefaultHandle);
-	}
+	m_TaskQueue.m_Read = 0;
+	m_TasksPending = 0;
 
+	m_WorkerParameters.resize(m_Threads);
+	m_Handles.resize(m_Threads);
 	for (__int32 iThread = 0; iThread < m_Threads; iThread++)
 	{
 		m_WorkerParameters[iThread].m_Thread = iThread;
@@ -54,29 +49,14 @@ void ThreadPool::initialize()
 DWORD WINAPI MainLoop(LPVOID voidParameters)
 {
 	const struct WorkerParameters* parameters = (struct WorkerParameters*)voidParameters;
-
-	const __int32 iThread = parameters->m_Thread;
 	ThreadPool& threadPool = *parameters->m_ThreadPool;
 
-	__int32 taskId = -1;
-	__int32 increment = 0;
-
 	while (true)
 	{
 		EnterCriticalSection(&threadPool.m_CriticalSection);
 
-		/*if (m_ThreadPool.m_TasksComplete.m_Jobs > 0)
-		{
-			m_ThreadPool.m_TasksComplete.ids.push_back(taskId);
-			m_ThreadPool.m_TasksComplete.m_Jobs += increment;
-			m_ThreadPool.m_TasksFinished += increment;
-			increment++;
-			std::cout << increment;
-		}*/
-
-		WakeAllConditionVariable(&threadPool.m_ProducerVariable);
-
-		while ((threadPool.m_TaskQueue.m_Jobs == 0) && threadPool.m_IsRunning)
+		TaskQueue& queue = threadPool.m_TaskQueue;
+		while (queue.m_Read == queue.m_QueueJobs.size() && threadPool.m_IsRunning)
 		{
 			SleepConditionVariableCS(&threadPool.m_ConsumerVariable, &threadPool.m_CriticalSection, INFINITE);
 		}
@@ -87,133 +67,96 @@ DWORD WINAPI MainLoop(LPVOID voidParameters)
 			return 0;
 		}
 
-		taskId = threadPool.m_TaskQueue.m_QueueJobs[threadPool.m_TaskQueue.m_Read]->m_ID;
-		__int32 readTemp = threadPool.m_TaskQueue.m_Read;
-		threadPool.m_TaskQueue.m_Jobs--;
-		threadPool.m_TaskQueue.m_Read++;
+		Ref<Task> task = queue.m_QueueJobs[queue.m_Read++];
+		if (queue.m_Read == queue.m_QueueJobs.size())
+		{
+			queue.m_QueueJobs.clear();
+			queue.m_Read = 0;
+		}
 
 		LeaveCriticalSection(&threadPool.m_CriticalSection);
 
-		threadPool.m_TaskQueue.m_QueueJobs[readTemp]->execute();
-		threadPool.m_TasksComplete.m_Jobs++;
+		if (task->execute())
+		{
+			threadPool.finish(task.get());
+		}
 	}
 	return 0;
 }
 
-void ThreadPool::submit(Vector<Ref<Task>>& tasks)
+void ThreadPool::enqueue(Vector<Ref<Task>>& tasks)
 {
-	join();
-
-	MasterThread masterThread;
-	masterThread.m_TasksComplete.m_Jobs = 0;
-	masterThread.m_TasksReady.m_Jobs = 0;
-	masterThread.m_TasksReady.m_Read = 0;
-	masterThread.m_TasksReady.m_Write = 0;
-
-	bool isTasksRemaining = true;
-
-	m_TasksFinished = 0;
-
+	EnterCriticalSection(&m_CriticalSection);
+	for (auto& task : tasks)
 	{
-		static __int32 idIndex = 0;
-		for (auto iJob : tasks)
-		{
-			iJob->m_Dependencies = 0;
-			m_TaskQueue.m_QueueJobs.push_back(iJob);
-			m_TaskQueue.m_QueueJobs[idIndex]->m_ID = idIndex;
-			idIndex++;
-		}
-
-		/*for (__int32 i_Job = 0; i_Job < tasks.size(); i_Job++)
-		{
-			for (__int32 i_Permission = 0; i_Permission < tasks[i_Job]->m_Permisions; i_Permission++)
-			{
-				tasks[tasks[i_Job]->i_Permissions[i_Permission]]->m_Dependencies++;
-			}
-		}*/
+		m_TaskQueue.m_QueueJobs.push_back(task);
 	}
+	m_TasksPending += (__int32)tasks.size();
+	LeaveCriticalSection(&m_CriticalSection);
 
-	while (isTasksRemaining)
-	{
+	WakeAllConditionVariable(&m_ConsumerVariable);
+}
 
-		/*{
-			const __int32 nJobs = master_thread.m_TasksComplete.m_Jobs;
-			for (__int32 i_job = 0; i_job < nJobs; i_job++)
-			{
-				__int32 taskId = master_thread.m_TasksComplete.ids[i_job];
-
-				for (__int32 i_Permission = 0; i_Permission < tasks[taskId]->m_Permisions; i_Permission++)
-				{
-					tasks[tasks[taskId]->i_Permissions[i_Permission]]->m_Dependencies--;
-				}
-				master_thread.m_TasksComplete.m_Jobs--;
-			}
-		}*/
-		{
-			__int32 iJob = 0;
-			while (iJob < tasks.size())
-			{
-				if (tasks[iJob]->m_Dependencies == 0)
-				{
-					masterThread.m_TasksReady.m_IDs.push_back(tasks[iJob]->m_ID);
-					masterThread.m_TasksReady.m_Write++;
-					masterThread.m_TasksReady.m_Jobs++;
-					tasks[iJob]->m_Dependencies--;
-				}
-				iJob++;
-			}
-		}
+void ThreadPool::finish(Task* task)
+{
+	EnterCriticalSection(&m_CriticalSection);
+	m_TasksPending--;
+	if (task->m_BatchRemaining)
+	{
+		(*task->m_BatchRemaining)--;
+	}
+	LeaveCriticalSection(&m_CriticalSection);
 
-		EnterCriticalSection(&m_CriticalSection);
+	WakeAllConditionVariable(&m_ProducerVariable);
+}
 
-		{
-			__int32 nJobs = masterThread.m_TasksReady.m_Jobs;
-			for (__int32 i_Job = 0; i_Job < nJobs; i_Job++)
-			{
-				m_TaskQueue.m_QueueJobs[m_TaskQueue.m_Write]->m_ID = masterThread.m_TasksReady.m_IDs[masterThread.m_TasksReady.m_Read];
-				m_TaskQueue.m_Write++;
-				m_TaskQueue.m_Jobs++;
-				m_TasksFinished++;
-				masterThread.m_TasksReady.m_Read++;
-				masterThread.m_TasksReady.m_Jobs--;
-			}
-		}
+void ThreadPool::submit(Vector<Ref<Task>>& tasks)
+{
+	enqueue(tasks);
+}
 
-		WakeAllConditionVariable(&m_ConsumerVariable);
+void ThreadPool::execute(Vector<Ref<Task>>& tasks)
+{
+	__int32 remaining = (__int32)tasks.size();
+	for (auto& task : tasks)
+	{
+		task->m_BatchRemaining = &remaining;
+	}
+	enqueue(tasks);
 
-		while ((m_TasksComplete.m_Jobs == 0) && m_IsRunning)
+	// Work on the batch from this thread too, so that it completes even if all workers are busy with older tasks
+	for (auto& task : tasks)
+	{
+		if (task->execute())
 		{
-			SleepConditionVariableCS(&m_ProducerVariable, &m_CriticalSection, INFINITE);
+			finish(task.get());
 		}
+	}
 
-		/*{
-			const __int32 nJobs = m_TasksComplete.m_Jobs;
-			for (__int32 i_Job = 0; i_Job < nJobs; i_Job++)
-			{
-
-				master_thread.m_TasksComplete.ids[i_Job] = m_TasksComplete.ids[i_Job];
-				master_thread.m_TasksComplete.m_Jobs++;
-				m_TasksComplete.m_Jobs--;
-			}
-		}*/
-
-		isTasksRemaining = m_TasksFinished < tasks.size();
-
-		LeaveCriticalSection(&m_CriticalSection);
+	EnterCriticalSection(&m_CriticalSection);
+	while (remaining > 0)
+	{
+		SleepConditionVariableCS(&m_ProducerVariable, &m_CriticalSection, INFINITE);
 	}
+	LeaveCriticalSection(&m_CriticalSection);
 }
 
 bool ThreadPool::isCompleted() const
 {
-	return m_TaskQueue.m_QueueJobs.size() == m_TasksComplete.m_Jobs;
+	EnterCriticalSection(&m_CriticalSection);
+	bool isCompleted = m_TasksPending == 0;
+	LeaveCriticalSection(&m_CriticalSection);
+	return isCompleted;
 }
 
 void ThreadPool::join() const
 {
-	while (!isCompleted())
+	EnterCriticalSection(&m_CriticalSection);
+	while (m_TasksPending > 0)
 	{
-		;
+		SleepConditionVariableCS(&m_ProducerVariable, &m_CriticalSection, INFINITE);
 	}
+	LeaveCriticalSection(&m_CriticalSection);
 }
 
 void ThreadPool::shutDown()
@@ -225,6 +168,7 @@ void ThreadPool::shutDown()
 	LeaveCriticalSection(&this->m_CriticalSection);
 	WakeAllConditionVariable(&this->m_ConsumerVariable);
 	WaitForMultipleObjects(m_Threads, m_Handles.data(), TRUE, INFINITE);
+	DeleteCriticalSection(&m_CriticalSection);
 }
 
 ThreadPool::ThreadPool()
@@ -10,17 +10,23 @@ class ThreadPool;
 /// Defines jobs to be run on threads.
 class Task
 {
+	/// Set by the first thread to start the task, so that a queued task can also be picked up by the thread waiting on it.
+	Atomic<bool> m_IsClaimed;
+	/// Unfinished tasks in the batch this task was executed with. nullptr for tasks that are only submitted.
+	__int32* m_BatchRemaining;
+
+	friend class ThreadPool;
+	friend DWORD WINAPI MainLoop(LPVOID voidParameters);
+
 public:
-	__int32 m_ID;
-	__int32 m_Dependencies;
-	Vector<__int32> m_Permissions;
 	Function<void()> m_ExecutionTask;
 
 	Task(const Function<void()>& executionTask);
-	Task(const Task&) = default;
+	Task(const Task&) = delete;
 	~Task() = default;
 
-	void execute();
+	/// Runs the task unless another thread has already claimed it. Returns true if this call ran the task.
+	bool execute();
 };
 
 /// Worker thread parameters.
@@ -33,66 +39,48 @@ struct WorkerParameters
 /// A queue of jobs.
 struct TaskQueue
 {
-	__int32 m_Jobs;
-	unsigned __int32 m_Write;
 	unsigned __int32 m_Read;
 	Vector<Ref<Task>> m_QueueJobs;
 };
 
-/// Contains the information of completed jobs.
-struct TaskComplete
-{
-	__int32 m_Jobs;
-	Vector<__int32> m_IDs;
-};
-
-/// Contains information of jobs ready for execution.
-struct TaskReady
-{	
-	__int32 m_Jobs;
-	unsigned __int32 m_Write;
-	unsigned __int32 m_Read;
-	Vector<__int32> m_IDs;
-};
-
-/// Master thread to communicate with and maintain worker threads.
-struct MasterThread
-{	
-	TaskComplete m_TasksComplete;
-	TaskReady m_TasksReady;
-};
-
 class ThreadPool
 {
 	bool m_IsRunning;
 	__int32 m_Threads;
 	Vector<WorkerParameters> m_WorkerParameters;
-	WorkerParameters m_DefaultWorkerParameter;
 	Vector<HANDLE> m_Handles;
-	HANDLE m_DefaultHandle = 0;
-	CONDITION_VARIABLE m_ConsumerVariable;
-	CONDITION_VARIABLE m_ProducerVariable;
-	CRITICAL_SECTION m_CriticalSection;
+	/// Signalled when new tasks are queued.
+	mutable CONDITION_VARIABLE m_ConsumerVariable;
+	/// Signalled when tasks finish.
+	mutable CONDITION_VARIABLE m_ProducerVariable;
+	mutable CRITICAL_SECTION m_CriticalSection;
 
-	__int32 m_TasksFinished;
 	TaskQueue m_TaskQueue;
-	TaskComplete m_TasksComplete;
+	/// Tasks submitted and not yet finished.
+	__int32 m_TasksPending;
 
 	friend DWORD WINAPI MainLoop(LPVOID voidParameters);
 
 	void initialize();
 	void shutDown();
+	void enqueue(Vector<Ref<Task>>& tasks);
+	/// Book-keeping after a task has been run by any thread.
+	void finish(Task* task);
 
 public:
 	ThreadPool();
 	ThreadPool(ThreadPool&) = delete;
 	~ThreadPool();	
 
-	/// To submit a job to the jobs queue.
+	/// To submit a job to the jobs queue. Returns without waiting for the jobs.
 	void submit(Vector<Ref<Task>>& tasks);
+	/// Runs the jobs on the worker threads and the calling thread. Returns when all of these jobs have been completed.
+	/// Jobs submitted earlier are not waited upon.
+	void execute(Vector<Ref<Task>>& tasks);
 
 	/// Returns true if all tasks have been completed
 	bool isCompleted() const;
 	/// Returns when all the tasks have been completed
 	void join() const;
+	__int32 getThreadCount() const { return m_Threads; }
 };
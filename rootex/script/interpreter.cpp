@@ -1,10 +1,14 @@
 #include "interpreter.h"
 #include "core/resource_loader.h"
+#include "core/memory_tracker.h"
 
 #include "common/common.h"
 #include "app/level_manager.h"
 #include "components/hierarchy_component.h"
 #include "components/transform_component.h"
+#include "transform_batch.h"
+#include "systems/spatial_system.h"
+#include "systems/visibility_system.h"
 #include "components/visual/text_ui_component.h"
 #include "components/visual/ui_component.h"
 #include "components/visual/model_component.h"
@@ -123,10 +127,14 @@ void LuaInterpreter::registerTypes()
 	ModelResourceFile::RegisterAPI(rootex);
 	ImageResourceFile::RegisterAPI(rootex);
 	FontResourceFile::RegisterAPI(rootex);
+	MemoryTracker::RegisterAPI(rootex);
 	
 	EntityFactory::RegisterAPI(rootex);
 	Entity::RegisterAPI(rootex);
 	TransformComponent::RegisterAPI(rootex);
+	TransformBatch::RegisterAPI(rootex);
+	SpatialSystem::RegisterAPI(rootex);
+	VisibilitySystem::RegisterAPI(rootex);
 	HierarchyComponent::RegisterAPI(rootex);
 	ModelComponent::RegisterAPI(rootex);
 	RenderUIComponent::RegisterAPI(rootex);